@@ -0,0 +1,203 @@
+// Stage benchmark
+//
+// Decodes every front sprite of a ROM (normally one written by romgen) a
+// number of times and reports how long each stage of the pipeline took,
+// followed by the time of a full `--all` run of the extractor, as JSON on
+// stdout.
+//
+//   bench <rom> <pkmn_sprite binary> [iterations]
+
+#include <chrono>
+#include <cstdlib>
+#include <filesystem>
+#include <iomanip>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include <cstdint>
+
+#include "gbemu/bitreader.hpp"
+#include "gbemu/cartridge.hpp"
+#include "gbemu/pokemon_red.hpp"
+#include "gbemu/romindex.hpp"
+#include "gbemu/romprofile.hpp"
+#include "gbemu/spritedecoder.hpp"
+#include "gbemu/spriterenderer.hpp"
+
+namespace {
+  using Clock = std::chrono::steady_clock;
+
+  enum STAGE {
+    BIT_READING,
+    RLE,
+    DELTA,
+    XOR_ZIP,
+    RENDER,
+    SAVE,
+    STAGE_COUNT
+  };
+
+  const char *stage_names[STAGE_COUNT] = {
+    "bit_reading", "rle", "delta", "xor_zip", "render", "save"
+  };
+
+  struct Timer {
+    Clock::time_point start = Clock::now();
+
+    // nanoseconds since the last call (or construction)
+    std::uint64_t lap() {
+      Clock::time_point now = Clock::now();
+      std::uint64_t ns = std::chrono::duration_cast<std::chrono::nanoseconds>(
+        now - start
+      ).count();
+      start = now;
+      return ns;
+    }
+  };
+
+  // consumed so the compiler cannot drop the bit reading loop
+  volatile std::uint64_t sink;
+}
+
+int main(int argc, char *argv[]) {
+  if (argc < 3) {
+    std::cerr << "usage: " << argv[0];
+    std::cerr << " <rom> <pkmn_sprite binary> [iterations]" << std::endl;
+    return 1;
+  }
+
+  std::filesystem::path rom_path = argv[1];
+  std::filesystem::path binary = std::filesystem::absolute(argv[2]);
+  std::size_t iterations = (argc >= 4) ? std::stoul(argv[3]) : 20;
+
+  Cartridge cart;
+  if (cart.load_rom(rom_path)) {
+    std::cerr << "Unable to load ROM " << rom_path << std::endl;
+    return 1;
+  }
+
+  pkmnred::ProfileRegistry profiles;
+  const pkmnred::RomProfile *profile = profiles.detect(cart);
+  if (profile == nullptr) {
+    std::cerr << "No rom profile for " << rom_path << std::endl;
+    return 1;
+  }
+
+  pkmnred::RomIndex rom_index;
+  try {
+    rom_index.build(cart, *profile);
+  } catch (std::out_of_range& e) {
+    std::cerr << e.what() << std::endl;
+    return 1;
+  }
+
+  std::vector<std::uint8_t> ids;
+  for (std::size_t dexno = 1; dexno <= rom_index.dex_count(); ++dexno) {
+    if (rom_index.id_from_dex(dexno) != 0) {
+      ids.push_back(rom_index.id_from_dex(dexno));
+    }
+  }
+
+  std::filesystem::path output = std::filesystem::temp_directory_path();
+  output /= "pkmn_sprite_bench";
+
+  std::uint64_t totals[STAGE_COUNT] = {};
+  std::uint64_t bits_read = 0;
+
+  for (std::size_t n = 0; n < iterations; ++n) {
+    for (std::uint8_t id : ids) {
+      std::uint8_t bank = rom_index.sprite_bank(id);
+      std::uint16_t offset = rom_index.front_sprite_offset(id);
+
+      Timer timer;
+
+      gbemu::Decoder decoder(cart.rom_data());
+      decoder.clear(0);
+      decoder.clear(1);
+      decoder.clear(2);
+      decoder.set_bank(bank);
+      decoder.set_offset(offset);
+      decoder.read_header();
+      decoder.rle_decode(decoder.primary_buffer);
+      decoder.read_encoding_mode();
+      decoder.rle_decode(decoder.secondary_buffer);
+      totals[RLE] += timer.lap();
+
+      decoder.delta_decode(decoder.primary_buffer);
+      if (decoder.encoding_mode != 2) {
+        decoder.delta_decode(decoder.secondary_buffer);
+      }
+      totals[DELTA] += timer.lap();
+
+      std::array<std::uint8_t, gbemu::SPRITE_SIZE> tiles;
+      decoder.finalise(tiles);
+      totals[XOR_ZIP] += timer.lap();
+
+      std::array<std::uint8_t, gbemu::RASTER_SIZE> raster;
+      gbemu::Renderer renderer(tiles, decoder.width, decoder.height);
+      renderer.render(raster);
+      totals[RENDER] += timer.lap();
+
+      std::stringstream ss;
+      ss << std::setw(3) << std::setfill('0') << int(rom_index.dexno(id));
+      renderer.save(output, ss.str(), gbemu::IMAGE_FORMAT::PGM, true);
+      totals[SAVE] += timer.lap();
+
+      // the raw bit reader over the same stream, two bits at a time like
+      // the data packets
+      std::size_t bits = decoder.rom_interface.tell() - ((offset - 0x4000) * 8);
+      timer.lap();
+
+      std::span<const std::uint8_t> sprite_bank = cart.read_at(
+        bank, 0x4000, 0x4000
+      );
+      gbemu::BitReader reader(sprite_bank.data(), sprite_bank.size());
+      reader.seek((offset - 0x4000) * 8);
+      std::uint64_t acc = 0;
+      for (std::size_t i = 0; i < bits; i += 2) {
+        acc += reader.get_pair();
+      }
+      sink = acc;
+      totals[BIT_READING] += timer.lap();
+
+      bits_read += bits;
+    }
+  }
+
+  // one full extraction with the real binary, in a scratch directory
+  std::filesystem::path run_directory = output / "full_run";
+  std::filesystem::create_directories(run_directory);
+
+  std::stringstream cmd;
+  cmd << "cd " << run_directory << " && " << binary << " -r ";
+  cmd << std::filesystem::absolute(rom_path) << " -a > /dev/null";
+
+  Timer timer;
+  int err = std::system(cmd.str().c_str());
+  std::uint64_t full_run = timer.lap();
+
+  std::filesystem::remove_all(output);
+
+  std::size_t sprites = ids.size() * iterations;
+
+  std::cout << "{\n";
+  std::cout << "  \"rom\": " << rom_path << ",\n";
+  std::cout << "  \"iterations\": " << iterations << ",\n";
+  std::cout << "  \"sprites\": " << sprites << ",\n";
+  std::cout << "  \"bits_read\": " << bits_read << ",\n";
+  std::cout << "  \"stages\": {\n";
+  for (std::size_t s = 0; s < STAGE_COUNT; ++s) {
+    std::cout << "    \"" << stage_names[s] << "\": {";
+    std::cout << "\"total_ms\": " << (totals[s] / 1e6) << ", ";
+    std::cout << "\"per_sprite_us\": " << (totals[s] / 1e3 / sprites) << "}";
+    std::cout << ((s + 1 < STAGE_COUNT) ? ",\n" : "\n");
+  }
+  std::cout << "  },\n";
+  std::cout << "  \"full_run\": {\"ms\": " << (full_run / 1e6);
+  std::cout << ", \"exit_code\": " << err << "}\n";
+  std::cout << "}" << std::endl;
+
+  return err ? 1 : 0;
+}
@@ -0,0 +1,473 @@
+// Synthetic ROM generator
+//
+// Writes a fake "POKEMON RED" image that has the same layout as the tables
+// described in gbemu/pokemon_red.hpp: header, pokedex order, stats, names,
+// type and move names, pokedex entries and compressed front/back sprites.
+// None of the data is copied from the real game; everything is generated from
+// a fixed seed so that runs are reproducible.
+
+#include <array>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include <cstdint>
+
+#include "gbemu/pokemon_red.hpp"
+#include "util/io.hpp"
+
+namespace {
+  constexpr std::size_t bank_size = 0x4000;
+  constexpr std::size_t rom_banks = 64;
+
+  class Rom {
+  public:
+    Rom() : bytes(bank_size * rom_banks, 0x00) {}
+
+    std::size_t address(std::uint8_t bank, std::uint16_t offset) const {
+      if (offset < bank_size) {
+        return offset;
+      }
+
+      return (bank * bank_size) + (offset - bank_size);
+    }
+
+    void write(std::uint8_t bank, std::uint16_t offset, std::uint8_t b) {
+      bytes.at(address(bank, offset)) = b;
+    }
+
+    void write(
+      std::uint8_t bank, std::uint16_t offset,
+      const std::vector<std::uint8_t> &data
+    ) {
+      for (std::size_t i = 0; i < data.size(); ++i) {
+        write(bank, offset + i, data[i]);
+      }
+    }
+
+    void write_address(
+      std::uint8_t bank, std::uint16_t offset, std::uint16_t value
+    ) {
+      write(bank, offset, value & 0xff);
+      write(bank, offset + 1, value >> 8);
+    }
+
+    std::vector<std::uint8_t> bytes;
+  };
+
+  class BitWriter {
+  public:
+    void put(bool b) {
+      if ((count % 8) == 0) {
+        bytes.push_back(0);
+      }
+
+      if (b) {
+        bytes.back() |= 0b10000000 >> (count % 8);
+      }
+
+      ++count;
+    }
+
+    void put_bits(std::uint32_t value, std::size_t n) {
+      for (std::size_t i = n; i > 0; --i) {
+        put((value >> (i - 1)) & 0b1);
+      }
+    }
+
+    std::vector<std::uint8_t> bytes;
+    std::size_t count = 0;
+  };
+
+  struct Random {
+    std::uint32_t state;
+
+    std::uint32_t next() {
+      state ^= state << 13;
+      state ^= state >> 17;
+      state ^= state << 5;
+      return state;
+    }
+
+    std::uint32_t range(std::uint32_t n) {
+      return next() % n;
+    }
+  };
+
+  // plane layout matches the decoder: column-major, one byte is 8 pixels wide
+  using Plane = std::array<std::uint8_t, 392>;
+
+  struct Image {
+    std::uint8_t width;
+    std::uint8_t height;
+    Plane low;
+    Plane high;
+  };
+
+  Image make_image(std::uint8_t width, std::uint8_t height, Random &rng) {
+    Image img {width, height, {}, {}};
+
+    int w = width * 8;
+    int h = height * 8;
+    int cx = w / 2;
+    int cy = h / 2 + int(rng.range(4));
+    int rx = (w / 2) - 2 - int(rng.range(4));
+    int ry = (h / 2) - 2 - int(rng.range(4));
+    int stripe = 3 + int(rng.range(5));
+
+    for (int y = 0; y < h; ++y) {
+      for (int x = 0; x < w; ++x) {
+        int dx = x - cx;
+        int dy = y - cy;
+        int d = (dx * dx * ry * ry) + (dy * dy * rx * rx);
+        int r = rx * rx * ry * ry;
+
+        std::uint8_t pixel = 0;
+        if (d <= r) {
+          pixel = 1;
+          if (((x + y) / stripe) % 3 == 0) {
+            pixel = 2;
+          }
+          if (d >= (r - (r / 6))) {
+            pixel = 3;
+          }
+          if (rng.range(23) == 0) {
+            pixel = rng.range(4);
+          }
+        }
+
+        std::size_t index = (x / 8) * h + y;
+        std::uint8_t mask = 0b10000000 >> (x % 8);
+        if (pixel & 0b01) {
+          img.low[index] |= mask;
+        }
+        if (pixel & 0b10) {
+          img.high[index] |= mask;
+        }
+      }
+    }
+
+    return img;
+  }
+
+  void delta_encode(Plane &plane, std::uint8_t width, std::uint8_t height) {
+    std::size_t num_rows = height * 8;
+
+    for (std::size_t row = 0; row < num_rows; ++row) {
+      bool previous = 0;
+      for (std::size_t col = 0; col < width; ++col) {
+        std::size_t index = row + (col * num_rows);
+        std::uint8_t b = plane[index];
+        std::uint8_t new_byte = 0;
+
+        for (int i = 8; i > 0; --i) {
+          bool bit = (b >> (i - 1)) & 0b1;
+          new_byte <<= 1;
+          new_byte |= (bit != previous);
+          previous = bit;
+        }
+
+        plane[index] = new_byte;
+      }
+    }
+  }
+
+  void rle_encode(
+    BitWriter &bw, const Plane &plane, std::uint8_t width, std::uint8_t height
+  ) {
+    std::size_t num_rows = height * 8;
+    std::vector<std::uint8_t> pairs;
+
+    for (std::size_t col = 0; col < std::size_t(width * 4); ++col) {
+      for (std::size_t row = 0; row < num_rows; ++row) {
+        std::uint8_t b = plane[((col / 4) * num_rows) + row];
+        pairs.push_back((b >> ((3 - (col % 4)) * 2)) & 0b11);
+      }
+    }
+
+    std::size_t i = 0;
+    bool packet_is_data = pairs[0] != 0;
+    bw.put(packet_is_data);
+
+    while (i < pairs.size()) {
+      if (packet_is_data) {
+        while ((i < pairs.size()) && (pairs[i] != 0)) {
+          bw.put_bits(pairs[i], 2);
+          ++i;
+        }
+
+        if (i < pairs.size()) {
+          bw.put_bits(0b00, 2);
+        }
+      } else {
+        std::size_t n = 0;
+        while ((i < pairs.size()) && (pairs[i] == 0)) {
+          ++n;
+          ++i;
+        }
+
+        std::size_t k = 1;
+        while (n > ((std::size_t(1) << (k + 1)) - 2)) {
+          ++k;
+        }
+
+        bw.put_bits((1 << k) - 2, k);
+        bw.put_bits(n - ((1 << k) - 1), k);
+      }
+
+      packet_is_data = !packet_is_data;
+    }
+  }
+
+  std::vector<std::uint8_t> compress(
+    const Image &img, std::uint8_t mode, bool swap
+  ) {
+    Plane primary = swap ? img.high : img.low;
+    Plane secondary = swap ? img.low : img.high;
+
+    if (mode != 1) {
+      for (std::size_t i = 0; i < secondary.size(); ++i) {
+        secondary[i] ^= primary[i];
+      }
+    }
+
+    delta_encode(primary, img.width, img.height);
+    if (mode != 2) {
+      delta_encode(secondary, img.width, img.height);
+    }
+
+    BitWriter bw;
+    bw.put_bits(img.width, 4);
+    bw.put_bits(img.height, 4);
+    bw.put(swap);
+    rle_encode(bw, primary, img.width, img.height);
+
+    if (mode == 1) {
+      bw.put(0);
+    } else {
+      bw.put_bits(mode == 2 ? 0b10 : 0b11, 2);
+    }
+
+    rle_encode(bw, secondary, img.width, img.height);
+
+    return bw.bytes;
+  }
+
+  std::vector<std::uint8_t> encode_text(const std::string &s) {
+    std::vector<std::uint8_t> data;
+
+    for (char c : s) {
+      if ((c >= 'A') && (c <= 'Z')) {
+        data.push_back(c + 0x3f);
+      } else if ((c >= 'a') && (c <= 'z')) {
+        data.push_back(c + 0x3f);
+      } else if ((c >= '0') && (c <= '9')) {
+        data.push_back(c + 0xc6);
+      } else if (c == '\n') {
+        data.push_back(0x4e);
+      } else if (c == '.') {
+        data.push_back(0xe8);
+      } else if (c == '-') {
+        data.push_back(0xe3);
+      } else {
+        data.push_back(0x7f);
+      }
+    }
+
+    data.push_back(pkmnred::eos_char);
+
+    return data;
+  }
+
+  std::string number_str(int n) {
+    std::stringstream ss;
+    ss.width(3);
+    ss.fill('0');
+    ss << n;
+    return ss.str();
+  }
+}
+
+int main(int argc, char *argv[]) {
+  if (argc < 2) {
+    std::cerr << "usage: " << argv[0] << " <output rom> [seed]" << std::endl;
+    return 1;
+  }
+
+  Random rng {0x5eed1234};
+  if (argc >= 3) {
+    rng.state = std::stoul(argv[2]);
+  }
+
+  Rom rom;
+
+  // header
+  for (std::size_t i = 0; i < pkmnred::name.size(); ++i) {
+    rom.write(0, 0x134 + i, pkmnred::name[i]);
+  }
+  rom.write(0, pkmnred::rom_size_pointer, 0x05);
+  rom.write(0, pkmnred::ram_size_pointer, 0x03);
+
+  // internal id <-> pokedex number
+  std::array<std::uint8_t, 256> index_to_dex {};
+  for (std::size_t i = 0; i < pkmnred::dex_to_index.size(); ++i) {
+    index_to_dex[pkmnred::dex_to_index[i]] = i + 1;
+  }
+
+  for (int id = pkmnred::minimum_index; id <= pkmnred::maximum_index; ++id) {
+    rom.write(
+      pkmnred::pokedex_order_table_bank,
+      pkmnred::pokedex_order_table_offset + (id - 1), index_to_dex[id]
+    );
+  }
+
+  // type names, pointer table followed by the strings
+  std::uint16_t type_string_offset = 0x7e00;
+  for (std::size_t t = 0; t < 27; ++t) {
+    rom.write_address(
+      pkmnred::type_names_pointer_bank,
+      pkmnred::type_names_pointer_offset + (t * 2), type_string_offset
+    );
+
+    auto s = encode_text("TYPE" + number_str(t));
+    rom.write(pkmnred::type_names_pointer_bank, type_string_offset, s);
+    type_string_offset += s.size();
+  }
+
+  // move names, stored back to back
+  std::uint16_t move_offset = 0x4000;
+  for (std::size_t m = 1; m <= 165; ++m) {
+    auto s = encode_text("MOVE" + number_str(m));
+    rom.write(0x2c, move_offset, s);
+    move_offset += s.size();
+  }
+
+  // pokedex entries, species name + 9 bytes, description text in bank 2b
+  std::uint16_t dex_data_offset = 0x6000;
+  std::uint16_t dex_text_offset = 0x4000;
+
+  // sprite data is packed from the start of each bank
+  std::array<std::uint16_t, 256> sprite_offsets;
+  sprite_offsets.fill(0x4000);
+  sprite_offsets[0x01] = 0x5000; // bank 01 also holds mew's stats
+  std::array<std::uint16_t, 256> sprite_limits;
+  sprite_limits.fill(0x8000);
+  sprite_limits[pkmnred::type_names_pointer_bank] =
+    pkmnred::type_names_pointer_offset;
+
+  for (int id = pkmnred::minimum_index; id <= pkmnred::maximum_index; ++id) {
+    std::uint8_t dexno = index_to_dex[id];
+
+    rom.write_address(
+      pkmnred::pokedex_data_pointer_bank,
+      pkmnred::pokedex_data_pointer_offset + ((id - 1) * 2), dex_data_offset
+    );
+
+    std::string name = "MON" + number_str(dexno);
+    auto name_data = encode_text(name);
+    name_data.resize(pkmnred::pokemon_names_table_width, pkmnred::eos_char);
+    rom.write(
+      pkmnred::pokemon_names_table_bank,
+      pkmnred::pokemon_names_table_offset +
+        ((id - 1) * pkmnred::pokemon_names_table_width),
+      name_data
+    );
+
+    auto species = encode_text("SPECIES" + number_str(dexno));
+    rom.write(pkmnred::pokedex_data_pointer_bank, dex_data_offset, species);
+    dex_data_offset += species.size();
+
+    std::uint16_t weight = 10 + rng.range(2000);
+    std::vector<std::uint8_t> dex_bytes = {
+      std::uint8_t(rng.range(8)), std::uint8_t(rng.range(12)),
+      std::uint8_t(weight & 0xff), std::uint8_t(weight >> 8),
+      0x00,
+      std::uint8_t(dex_text_offset & 0xff), std::uint8_t(dex_text_offset >> 8),
+      0x00, 0x00
+    };
+    rom.write(pkmnred::pokedex_data_pointer_bank, dex_data_offset, dex_bytes);
+    dex_data_offset += dex_bytes.size();
+
+    auto text = encode_text(
+      "Synthetic entry\nnumber " + number_str(dexno) + ".\nNot real data."
+    );
+    rom.write(0x2b, dex_text_offset, 0x00);
+    rom.write(0x2b, dex_text_offset + 1, text);
+    dex_text_offset += text.size() + 1;
+
+    if (dexno == 0) {
+      continue;
+    }
+
+    // sprites
+    std::uint8_t bank = pkmnred::sprite_banks[id - 1];
+    std::uint8_t size = 5 + (dexno % 3);
+
+    Image front = make_image(size, size, rng);
+    Image back = make_image(4, 4, rng);
+
+    auto front_data = compress(front, 1 + (dexno % 3), dexno % 2);
+    auto back_data = compress(back, 1 + ((dexno + 1) % 3), (dexno / 2) % 2);
+
+    std::uint16_t front_offset = sprite_offsets[bank];
+    std::uint16_t back_offset = front_offset + front_data.size();
+    sprite_offsets[bank] = back_offset + back_data.size();
+
+    if (sprite_offsets[bank] > sprite_limits[bank]) {
+      std::cerr << "sprite bank " << int(bank) << " overflowed" << std::endl;
+      return 1;
+    }
+
+    rom.write(bank, front_offset, front_data);
+    rom.write(bank, back_offset, back_data);
+
+    // stats
+    std::vector<std::uint8_t> stats(pkmnred::pokemon_stats_table_width, 0);
+    stats[0] = dexno;
+    for (std::size_t i = 1; i <= 5; ++i) {
+      stats[i] = 20 + rng.range(120);
+    }
+    stats[6] = rng.range(27);
+    stats[7] = rng.range(27);
+    stats[8] = 3 + rng.range(250);
+    stats[9] = 30 + rng.range(200);
+    stats[10] = (size << 4) | size;
+    stats[11] = front_offset & 0xff;
+    stats[12] = front_offset >> 8;
+    stats[13] = back_offset & 0xff;
+    stats[14] = back_offset >> 8;
+    stats[15] = 1 + rng.range(165);
+    stats[16] = rng.range(166);
+    stats[17] = rng.range(166);
+    stats[18] = rng.range(166);
+    for (std::size_t i = 19; i < 27; ++i) {
+      stats[i] = rng.range(256);
+    }
+
+    if (dexno == 151) {
+      rom.write(
+        pkmnred::mew_stats_table_bank, pkmnred::mew_stats_table_offset, stats
+      );
+    } else {
+      rom.write(
+        pkmnred::pokemon_stats_table_bank,
+        pkmnred::pokemon_stats_table_offset +
+          ((dexno - 1) * pkmnred::pokemon_stats_table_width),
+        stats
+      );
+    }
+  }
+
+  // global checksum, big endian, excludes the checksum bytes themselves
+  std::uint16_t checksum = 0;
+  for (std::size_t i = 0; i < rom.bytes.size(); ++i) {
+    if ((i != 0x14e) && (i != 0x14f)) {
+      checksum += rom.bytes[i];
+    }
+  }
+  rom.write(0, 0x14e, checksum >> 8);
+  rom.write(0, 0x14f, checksum & 0xff);
+
+  return writeToFile(argv[1], rom.bytes, true);
+}
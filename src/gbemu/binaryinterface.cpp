@@ -3,17 +3,22 @@
 #include "binaryinterface.hpp"
 
 gbemu::BinaryInterface::BinaryInterface(
-  std::array<std::uint8_t, 0x4000> &buffer
+  std::span<std::uint8_t> buffer
 ) : buffer(buffer), pointer(0) {}
 
 
 void gbemu::BinaryInterface::attach_buffer(
-  std::array<std::uint8_t, 0x4000> &new_buffer
+  std::span<std::uint8_t> new_buffer
 ) {
+  // rebinds the view, nothing is copied
   buffer = new_buffer;
 }
 
-std::array<std::uint8_t, 0x4000> &gbemu::BinaryInterface::data() const {
+std::size_t gbemu::BinaryInterface::size() const {
+  return buffer.size() * 8;
+}
+
+std::span<std::uint8_t> gbemu::BinaryInterface::data() const {
   return buffer;
 }
 
@@ -68,12 +73,15 @@ std::uint8_t gbemu::BinaryInterface::get_byte() {
 }
 
 std::uint8_t gbemu::BinaryInterface::get_bits(std::size_t n) {
-  std::uint8_t p = 0;
-
-  for (std::size_t i = 0; i < n; ++i) {
-    p <<= 1;
-    p |= get();
+  // n <= 8, so the bits always come from (at most) two bytes
+  std::size_t byte_index = pointer / 8;
+  std::uint16_t word = buffer[byte_index] << 8;
+  if (byte_index + 1 < buffer.size()) {
+    word |= buffer[byte_index + 1];
   }
 
-  return p;
+  word <<= (pointer % 8);
+  pointer += n;
+
+  return word >> (16 - n);
 }
@@ -1,17 +1,17 @@
 #ifndef __GBEMU_BINARYINTERFACE_HPP__
 #define __GBEMU_BINARYINTERFACE_HPP__
 
-#include <array>
+#include <span>
 #include <cstdint> // std::size_t
 
 namespace gbemu {
   class BinaryInterface {
   public:
-    BinaryInterface(std::array<std::uint8_t, 0x4000> &buffer);
-    void attach_buffer(std::array<std::uint8_t, 0x4000> &buffer);
+    BinaryInterface(std::span<std::uint8_t> buffer);
+    void attach_buffer(std::span<std::uint8_t> buffer);
 
     std::size_t size() const;
-    std::array<std::uint8_t, 0x4000> &data() const;
+    std::span<std::uint8_t> data() const;
 
     void seek(std::size_t p);
     std::size_t tell() const;
@@ -27,7 +27,7 @@ namespace gbemu {
 
   private:
     std::uint8_t get_bits(std::size_t n);
-    std::array<std::uint8_t, 0x4000> &buffer;
+    std::span<std::uint8_t> buffer;
     std::size_t pointer;
   };
 }
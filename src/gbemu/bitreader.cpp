@@ -0,0 +1,175 @@
+#include <cstring> // std::memcpy
+
+#include "bitreader.hpp"
+
+namespace {
+  std::uint64_t load_be64(const std::uint8_t *p) {
+    std::uint64_t word;
+    std::memcpy(&word, p, sizeof(word));
+
+#if __BYTE_ORDER__ == __ORDER_LITTLE_ENDIAN__
+    word = __builtin_bswap64(word);
+#endif
+
+    return word;
+  }
+}
+
+gbemu::BitReader::BitReader() : BitReader(nullptr, 0) {}
+
+gbemu::BitReader::BitReader(const std::uint8_t *data, std::size_t size)
+: buffer(data), buffer_size(size), accumulator(0), bits_available(0),
+  next_byte(0), overrun(false)
+{}
+
+void gbemu::BitReader::attach_buffer(
+  const std::uint8_t *data, std::size_t size
+) {
+  buffer = data;
+  buffer_size = size;
+  seek(0);
+}
+
+std::size_t gbemu::BitReader::size() const {
+  return buffer_size * 8;
+}
+
+bool gbemu::BitReader::exhausted() const {
+  return overrun;
+}
+
+void gbemu::BitReader::seek(std::size_t p) {
+  accumulator = 0;
+  bits_available = 0;
+  overrun = false;
+  next_byte = p / 8;
+
+  if (next_byte > buffer_size) {
+    next_byte = buffer_size;
+    overrun = true;
+    return;
+  }
+
+  get_bits(p % 8);
+}
+
+std::size_t gbemu::BitReader::tell() const {
+  return (next_byte * 8) - bits_available;
+}
+
+bool gbemu::BitReader::get() {
+  return get_bits(1) != 0;
+}
+
+std::uint64_t gbemu::BitReader::get_bits(std::size_t n) {
+  if (n == 0) {
+    return 0;
+  }
+
+  if (bits_available < n) {
+    refill();
+
+    if (bits_available < n) {
+      // past the end, missing bits are already zero in the accumulator
+      overrun = true;
+      std::uint64_t bits = accumulator >> (64 - n);
+      accumulator = 0;
+      bits_available = 0;
+      return bits;
+    }
+  }
+
+  std::uint64_t bits = accumulator >> (64 - n);
+  accumulator <<= n;
+  bits_available -= n;
+
+  return bits;
+}
+
+void gbemu::BitReader::skip(std::size_t n) {
+  if (n < bits_available) {
+    accumulator <<= n;
+    bits_available -= n;
+    return;
+  }
+
+  n -= bits_available;
+  accumulator = 0;
+  bits_available = 0;
+
+  next_byte += n / 8;
+  if (next_byte > buffer_size) {
+    next_byte = buffer_size;
+    overrun = true;
+    return;
+  }
+
+  get_bits(n % 8);
+}
+
+std::size_t gbemu::BitReader::count_ones() {
+  std::size_t count = 0;
+
+  while (true) {
+    if (bits_available == 0) {
+      refill();
+
+      if (bits_available == 0) {
+        overrun = true;
+        return count;
+      }
+    }
+
+    // bits past bits_available are always zero, so this stops there
+    std::size_t ones = (accumulator == ~std::uint64_t(0))
+      ? 64 : __builtin_clzll(~accumulator);
+
+    if (ones < bits_available) {
+      // drop the ones and the terminating zero (ones + 1 <= 64)
+      accumulator = (ones == 63) ? 0 : (accumulator << (ones + 1));
+      bits_available -= (ones + 1);
+      return count + ones;
+    }
+
+    count += bits_available;
+    accumulator = 0;
+    bits_available = 0;
+  }
+}
+
+std::uint8_t gbemu::BitReader::get_pair() {
+  return get_bits(2);
+}
+
+std::uint8_t gbemu::BitReader::get_nibble() {
+  return get_bits(4);
+}
+
+std::uint8_t gbemu::BitReader::get_byte() {
+  return get_bits(8);
+}
+
+void gbemu::BitReader::refill() {
+  if (bits_available > 56) {
+    return;
+  }
+
+  if (next_byte + 8 <= buffer_size) {
+    // take as many whole bytes as fit behind the bits already buffered
+    std::size_t byte_count = (64 - bits_available) / 8;
+    std::uint64_t word = load_be64(buffer + next_byte) >> bits_available;
+    word &= ~std::uint64_t(0) << ((64 - bits_available) % 8);
+
+    accumulator |= word;
+    bits_available += byte_count * 8;
+    next_byte += byte_count;
+    return;
+  }
+
+  // close to the end of the buffer, one byte at a time
+  while ((bits_available <= 56) && (next_byte < buffer_size)) {
+    accumulator |= std::uint64_t(buffer[next_byte]) << (56 - bits_available);
+    bits_available += 8;
+    ++next_byte;
+  }
+}
@@ -0,0 +1,53 @@
+#ifndef __GBEMU_BITREADER_HPP__
+#define __GBEMU_BITREADER_HPP__
+
+#include <cstdint> // std::size_t, std::uint8_t, std::uint64_t
+
+namespace gbemu {
+  // Read-only, MSB-first bit reader.
+  //
+  // Bits are buffered in a 64-bit accumulator (left aligned) which is refilled
+  // a whole word at a time, so multi-bit reads, runs of ones and skips do not
+  // have to go back to memory for every bit.
+  //
+  // Reading past the end of the attached buffer does not throw, the missing
+  // bits read as zero and exhausted() is set.
+  class BitReader {
+  public:
+    BitReader();
+    BitReader(const std::uint8_t *data, std::size_t size);
+    void attach_buffer(const std::uint8_t *data, std::size_t size);
+
+    std::size_t size() const;
+    bool exhausted() const;
+
+    void seek(std::size_t p);
+    std::size_t tell() const;
+
+    bool get();
+    // n must be <= 56
+    std::uint64_t get_bits(std::size_t n);
+    void skip(std::size_t n);
+    // consumes a run of 1 bits and the 0 that ends it, returns the run length
+    std::size_t count_ones();
+
+    ////
+
+    std::uint8_t get_pair();
+    std::uint8_t get_nibble();
+    std::uint8_t get_byte();
+
+  private:
+    void refill();
+
+    const std::uint8_t *buffer;
+    std::size_t buffer_size;
+
+    std::uint64_t accumulator;
+    std::size_t bits_available;
+    std::size_t next_byte;
+    bool overrun;
+  };
+}
+
+#endif // __GBEMU_BITREADER_HPP__
@@ -1,33 +1,61 @@
+#include <algorithm>
 #include <exception>
 
-#include "../util/io.hpp"
+#include <cstring> // std::memchr
+
 #include "helpers.hpp"
 
 #include "cartridge.hpp"
 
-void Cartridge::load_rom(const std::filesystem::path &rom_path) {
-  rom = loadFromFile(rom_path);
+namespace {
+  constexpr std::size_t bank_size = 0x4000;
+}
 
-  std::copy(
-    rom.begin(), rom.begin() + 0x4000,
-    bank0.begin()
-  );
+int Cartridge::load_rom(const std::filesystem::path &rom_path) {
+  rom_file = std::make_shared<const MappedFile>(rom_path);
+  rom = rom_file->data();
 
-  std::copy(
-    rom.begin() + 0x4000, rom.begin() + 0x8000,
-    bank1.begin()
-  );
+  // need at least bank00 and one switchable bank
+  if (rom.size() < 0x8000) {
+    bank0 = {};
+    bank1 = {};
+    return 1;
+  }
+
+  bank0 = rom.first(0x4000);
+  bank1 = rom.subspan(0x4000, 0x4000);
 
   ram.fill(0);
+
+  return 0;
 }
 
 void Cartridge::switch_bank(std::uint8_t banknumber) {
-  std::uint32_t offset = (banknumber * 0x4000);
+  std::size_t offset = (banknumber * 0x4000);
 
-  std::copy(
-    rom.begin() + offset, rom.begin() + offset + 0x4000,
-    bank1.begin()
-  );
+  if (offset + 0x4000 > rom.size()) {
+    std::stringstream ss;
+    ss << "bank out of range " << gbhelp::hex_str(banknumber, 1);
+
+    throw std::out_of_range(ss.str());
+  }
+
+  bank1 = rom.subspan(offset, 0x4000);
+}
+
+std::uint64_t Cartridge::fingerprint() const {
+  std::uint64_t hash = 0xcbf29ce484222325;
+
+  for (std::uint8_t b : rom) {
+    hash ^= b;
+    hash *= 0x100000001b3;
+  }
+
+  return hash;
+}
+
+std::span<const std::uint8_t> Cartridge::rom_data() const {
+  return rom;
 }
 
 std::uint8_t Cartridge::read(std::uint16_t address) {
@@ -132,3 +160,104 @@ void Cartridge::write(
     write(address + i, data[i]);
   }
 }
+
+std::uint32_t Cartridge::absolute(
+  std::uint8_t bank, std::size_t address, std::size_t count
+) const {
+  // bank 0 is only ever read as bank 0
+  std::size_t end = (address < bank_size) ? bank_size : bank_size * 2;
+
+  if ((address >= bank_size * 2) || (count > end - address)) {
+    std::stringstream ss;
+    ss << "read out of range @ " << gbhelp::hex_str(bank, 1) << ":";
+    ss << gbhelp::hex_str(address, 2, false);
+
+    throw std::out_of_range(ss.str());
+  }
+
+  return gbhelp::absolute_address(bank, address);
+}
+
+std::uint8_t Cartridge::read_at(
+  std::uint8_t bank, std::uint16_t address
+) const {
+  return rom_bytes(absolute(bank, address, 1), 1)[0];
+}
+
+std::span<const std::uint8_t> Cartridge::read_at(
+  std::uint8_t bank, std::uint16_t address, std::size_t count
+) const {
+  return rom_bytes(absolute(bank, address, count), count);
+}
+
+std::uint16_t Cartridge::read_address_at(
+  std::uint8_t bank, std::uint16_t address
+) const {
+  std::span<const std::uint8_t> data = read_at(bank, address, 2);
+
+  return (data[1] << 8) | data[0];
+}
+
+std::uint16_t Cartridge::read_address_from_table_at(
+  std::uint8_t bank, std::uint16_t address, std::uint16_t index,
+  std::uint16_t count
+) const {
+  std::size_t offset = address + (std::size_t(index) * count);
+  std::span<const std::uint8_t> data = rom_bytes(
+    absolute(bank, offset, 2), 2
+  );
+
+  return (data[1] << 8) | data[0];
+}
+
+std::span<const std::uint8_t> Cartridge::read_from_table_at(
+  std::uint8_t bank, std::uint16_t address, std::uint16_t index,
+  std::uint16_t count
+) const {
+  std::size_t offset = address + (std::size_t(index) * count);
+
+  return rom_bytes(absolute(bank, offset, count), count);
+}
+
+std::span<const std::uint8_t> Cartridge::read_string_at(
+  std::uint8_t bank, std::uint16_t address, std::uint8_t nullchar
+) const {
+  return rom_string(absolute(bank, address, 1), nullchar);
+}
+
+std::span<const std::uint8_t> Cartridge::rom_bytes(
+  std::uint32_t address, std::size_t count
+) const {
+  if ((address > rom.size()) || (count > rom.size() - address)) {
+    std::stringstream ss;
+    ss << "read out of range @ " << gbhelp::hex_str(address, 3);
+
+    throw std::out_of_range(ss.str());
+  }
+
+  return rom.subspan(address, count);
+}
+
+std::span<const std::uint8_t> Cartridge::rom_string(
+  std::uint32_t address, std::uint8_t nullchar
+) const {
+  // a string never runs on into the next bank
+  std::size_t end = std::min(
+    ((address / bank_size) + 1) * bank_size, rom.size()
+  );
+
+  const void *found = nullptr;
+  if (address < end) {
+    found = std::memchr(rom.data() + address, nullchar, end - address);
+  }
+
+  if (found == nullptr) {
+    std::stringstream ss;
+    ss << "unterminated string @ " << gbhelp::hex_str(address, 3);
+
+    throw std::out_of_range(ss.str());
+  }
+
+  std::size_t length = static_cast<const std::uint8_t *>(found) - rom.data();
+  return rom.subspan(address, (length - address) + 1);
+}
@@ -3,17 +3,28 @@
 
 #include <filesystem>
 #include <array>
+#include <memory>
+#include <span>
 #include <vector>
 
 #include <cstdint> // std::uint8_t
 
+#include "../util/io.hpp"
+
 class Cartridge {
 public:
   Cartridge() = default;
 
-  void load_rom(const std::filesystem::path &rom_path);
+  int load_rom(const std::filesystem::path &rom_path);
   void switch_bank(std::uint8_t banknumber);
 
+  // FNV-1a hash of the whole rom, identifies a dump for on-disk caches
+  std::uint64_t fingerprint() const;
+
+  // the whole rom, every bank, for readers that do their own banking (see
+  // gbemu::Decoder)
+  std::span<const std::uint8_t> rom_data() const;
+
   std::uint8_t read(std::uint16_t address);
   void write(std::uint16_t address, std::uint8_t data);
 
@@ -39,11 +50,51 @@ public:
     std::uint16_t address, std::vector<std::uint8_t> data, std::uint16_t count
   );
 
-  std::array<std::uint8_t, 0x4000> bank0;
-  std::array<std::uint8_t, 0x4000> bank1;
+  // Reads that do not depend on switch_bank(), so one cartridge can be read
+  // from any number of threads. Addresses 0x4000 to 0x7fff are looked up in
+  // the given bank, lower ones in bank 0 (see gbhelp::absolute_address()).
+  // Spans point into the rom and are valid while the cartridge is. Reads
+  // past the end of the bank or the rom throw std::out_of_range.
+  std::uint8_t read_at(std::uint8_t bank, std::uint16_t address) const;
+  std::span<const std::uint8_t> read_at(
+    std::uint8_t bank, std::uint16_t address, std::size_t count
+  ) const;
+  std::uint16_t read_address_at(std::uint8_t bank, std::uint16_t address) const;
+  std::uint16_t read_address_from_table_at(
+    std::uint8_t bank, std::uint16_t address, std::uint16_t index,
+    std::uint16_t count=2
+  ) const;
+  std::span<const std::uint8_t> read_from_table_at(
+    std::uint8_t bank, std::uint16_t address, std::uint16_t index,
+    std::uint16_t count
+  ) const;
+  // the terminator is included, as with read_string()
+  std::span<const std::uint8_t> read_string_at(
+    std::uint8_t bank, std::uint16_t address, std::uint8_t nullchar=0x00
+  ) const;
+
+  // the same by linear rom address (bank * 0x4000 + offset in the bank)
+  std::span<const std::uint8_t> rom_bytes(
+    std::uint32_t address, std::size_t count
+  ) const;
+  std::span<const std::uint8_t> rom_string(
+    std::uint32_t address, std::uint8_t nullchar=0x00
+  ) const;
+
+  // views into the loaded rom, switching banks only moves bank1
+  std::span<const std::uint8_t> bank0;
+  std::span<const std::uint8_t> bank1;
   std::array<std::uint8_t, 0x4000> ram;
 private:
-  std::vector<std::uint8_t> rom;
+  // linear address of count bytes at bank:address, throws if they would
+  // run past the end of the bank
+  std::uint32_t absolute(
+    std::uint8_t bank, std::size_t address, std::size_t count
+  ) const;
+
+  // shared so that copies of a cartridge do not copy (or remap) the rom
+  std::shared_ptr<const MappedFile> rom_file;
+  std::span<const std::uint8_t> rom;
 };
 
 #endif // __GBEMU_CARTRIDGE_HPP__
@@ -0,0 +1,181 @@
+#include <algorithm>
+#include <array>
+
+#if defined(__x86_64__)
+#include <immintrin.h>
+#endif
+
+#include "delta.hpp"
+
+namespace {
+  // prefix XOR of a byte, starting from the most significant bit
+  constexpr std::array<std::uint8_t, 256> make_prefix_table() {
+    std::array<std::uint8_t, 256> table {};
+
+    for (int b = 0; b < 256; ++b) {
+      std::uint8_t x = b;
+      x ^= x >> 1;
+      x ^= x >> 2;
+      x ^= x >> 4;
+      table[b] = x;
+    }
+
+    return table;
+  }
+
+  constexpr std::array<std::uint8_t, 256> prefix_table = make_prefix_table();
+
+  void decode_table_rows(
+    std::uint8_t *plane, std::size_t num_rows, std::size_t num_cols,
+    std::size_t first_row
+  ) {
+    for (std::size_t row = first_row; row < num_rows; ++row) {
+      std::uint8_t carry = 0x00;
+
+      for (std::size_t col = 0; col < num_cols; ++col) {
+        std::uint8_t &b = plane[row + (col * num_rows)];
+        b = prefix_table[b] ^ carry;
+        carry = -(b & 0b1);
+      }
+    }
+  }
+}
+
+void gbemu::delta::decode_reference(
+  std::uint8_t *plane, std::size_t num_rows, std::size_t num_cols
+) {
+  for (std::size_t row = 0; row < num_rows; ++row) {
+    bool do_one = 0;
+    for (std::size_t col = 0; col < num_cols; ++col) {
+      std::size_t index = row + (col * num_rows);
+
+      std::uint8_t b = plane[index];
+      std::uint8_t new_byte = 0;
+
+      for (int i = 8; i > 0; --i) {
+        bool is_one = (b >> (i - 1)) & 0b1;
+
+        if (is_one) {
+          do_one = !do_one;
+        }
+
+        new_byte <<= 1;
+        if (do_one) {
+          new_byte |= 0b1;
+        }
+      }
+
+      plane[index] = new_byte;
+    }
+  }
+}
+
+void gbemu::delta::decode_table(
+  std::uint8_t *plane, std::size_t num_rows, std::size_t num_cols
+) {
+  decode_table_rows(plane, num_rows, num_cols, 0);
+}
+
+#if defined(__x86_64__)
+
+__attribute__((target("pclmul,sse2")))
+void gbemu::delta::decode_pclmul(
+  std::uint8_t *plane, std::size_t num_rows, std::size_t num_cols
+) {
+  const __m128i ones = _mm_set1_epi64x(-1);
+
+  for (std::size_t row = 0; row < num_rows; ++row) {
+    std::uint64_t carry = 0;
+
+    for (std::size_t first_col = 0; first_col < num_cols; first_col += 8) {
+      std::size_t count = std::min<std::size_t>(8, num_cols - first_col);
+
+      // leftmost column in the top byte
+      std::uint64_t word = 0;
+      for (std::size_t i = 0; i < count; ++i) {
+        std::size_t index = row + ((first_col + i) * num_rows);
+        word |= std::uint64_t(plane[index]) << (56 - (i * 8));
+      }
+
+      // bit 63 + i of word * (2^64 - 1) is the XOR of bits i..63 of word
+      __m128i product = _mm_clmulepi64_si128(
+        _mm_cvtsi64_si128(word), ones, 0x00
+      );
+      std::uint64_t lo = _mm_cvtsi128_si64(product);
+      std::uint64_t hi = _mm_cvtsi128_si64(
+        _mm_unpackhi_epi64(product, product)
+      );
+      std::uint64_t decoded = ((hi << 1) | (lo >> 63)) ^ carry;
+
+      for (std::size_t i = 0; i < count; ++i) {
+        std::size_t index = row + ((first_col + i) * num_rows);
+        plane[index] = decoded >> (56 - (i * 8));
+      }
+
+      carry = -((decoded >> (64 - (count * 8))) & 0b1);
+    }
+  }
+}
+
+__attribute__((target("avx2")))
+void gbemu::delta::decode_avx2(
+  std::uint8_t *plane, std::size_t num_rows, std::size_t num_cols
+) {
+  const __m256i mask_1 = _mm256_set1_epi8(0x7f);
+  const __m256i mask_2 = _mm256_set1_epi8(0x3f);
+  const __m256i mask_4 = _mm256_set1_epi8(0x0f);
+  const __m256i lsb = _mm256_set1_epi8(0x01);
+
+  // rows are contiguous within a column, so 32 rows decode side by side
+  std::size_t row = 0;
+  for (; row + 32 <= num_rows; row += 32) {
+    __m256i carry = _mm256_setzero_si256();
+
+    for (std::size_t col = 0; col < num_cols; ++col) {
+      std::uint8_t *column = plane + row + (col * num_rows);
+      __m256i *p = reinterpret_cast<__m256i *>(column);
+      __m256i x = _mm256_loadu_si256(p);
+
+      // per byte prefix XOR, there are no 8-bit shifts so mask off the bits
+      // shifted in from the neighbouring byte
+      __m256i s;
+      s = _mm256_and_si256(_mm256_srli_epi16(x, 1), mask_1);
+      x = _mm256_xor_si256(x, s);
+      s = _mm256_and_si256(_mm256_srli_epi16(x, 2), mask_2);
+      x = _mm256_xor_si256(x, s);
+      s = _mm256_and_si256(_mm256_srli_epi16(x, 4), mask_4);
+      x = _mm256_xor_si256(x, s);
+      x = _mm256_xor_si256(x, carry);
+
+      _mm256_storeu_si256(p, x);
+
+      carry = _mm256_cmpeq_epi8(_mm256_and_si256(x, lsb), lsb);
+    }
+  }
+
+  decode_table_rows(plane, num_rows, num_cols, row);
+}
+
+bool gbemu::delta::has_pclmul() {
+  return __builtin_cpu_supports("pclmul");
+}
+
+bool gbemu::delta::has_avx2() {
+  return __builtin_cpu_supports("avx2");
+}
+
+#endif
+
+gbemu::delta::Kernel gbemu::delta::select_kernel() {
+#if defined(__x86_64__)
+  if (has_avx2()) {
+    return decode_avx2;
+  }
+
+  if (has_pclmul()) {
+    return decode_pclmul;
+  }
+#endif
+
+  return decode_table;
+}
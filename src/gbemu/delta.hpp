@@ -0,0 +1,49 @@
+#ifndef __GBEMU_DELTA_HPP__
+#define __GBEMU_DELTA_HPP__
+
+#include <cstdint> // std::size_t, std::uint8_t
+
+// Delta decoding kernels
+//
+// A plane is stored column-major: num_rows bytes for the first 8 pixel wide
+// column, then the next column and so on. Decoding a row is a prefix XOR from
+// the leftmost bit, with the running value carried from one column to the
+// next (see docs/delta.md). Every kernel decodes the plane in place and gives
+// the same result as decode_reference().
+namespace gbemu {
+  namespace delta {
+    using Kernel = void (*)(
+      std::uint8_t *plane, std::size_t num_rows, std::size_t num_cols
+    );
+
+    // bit by bit, kept as the reference implementation
+    void decode_reference(
+      std::uint8_t *plane, std::size_t num_rows, std::size_t num_cols
+    );
+
+    // one 256 entry table lookup per byte, carry passed between columns
+    void decode_table(
+      std::uint8_t *plane, std::size_t num_rows, std::size_t num_cols
+    );
+
+#if defined(__x86_64__)
+    // a whole row (up to 8 columns) per carry-less multiply
+    void decode_pclmul(
+      std::uint8_t *plane, std::size_t num_rows, std::size_t num_cols
+    );
+
+    // 32 rows at a time, one column after another
+    void decode_avx2(
+      std::uint8_t *plane, std::size_t num_rows, std::size_t num_cols
+    );
+
+    bool has_pclmul();
+    bool has_avx2();
+#endif
+
+    // fastest kernel supported by the running cpu
+    Kernel select_kernel();
+  }
+}
+
+#endif // __GBEMU_DELTA_HPP__
@@ -21,7 +21,7 @@ std::string gbhelp::hex_str(
 std::uint32_t gbhelp::absolute_address(
   std::uint8_t bank, std::uint16_t offset, std::uint16_t bank_size
 ) {
-  if ((offset > bank_size) && (offset < (bank_size * 2))) {
+  if ((offset >= bank_size) && (offset < (bank_size * 2))) {
     std::uint32_t addr = bank_size * bank;
     addr += (offset - bank_size);
     return addr;
@@ -30,45 +30,57 @@ std::uint32_t gbhelp::absolute_address(
   return offset;
 }
 
-std::string gbhelp::decode_string(
-  const std::vector<std::uint8_t> &raw_data,
-  const std::map<std::uint8_t, std::string> &charactermap,
-  std::uint8_t eos_char
+void gbhelp::decode_string(
+  std::span<const std::uint8_t> raw_data, const CharTable &charactermap,
+  std::uint8_t eos_char, std::string &output, DecodeReport *report
 ) {
-  std::stringstream ss;
-
   for (std::uint8_t b : raw_data) {
     if (b == eos_char) {
       break;
     }
-    try {
-      ss << charactermap.at(b);
-    } catch (std::out_of_range &e) {
-      ss << "·";
-      std::cout << "unknown character index " << hex_str(b, 1) << "\n";
+
+    std::string_view c = charactermap[b];
+    if (c.empty()) {
+      output += "·";
+
+      if (report) {
+        ++report->unknown_total;
+        ++report->unknown[b];
+      }
+      continue;
     }
+
+    output += c;
   }
+}
 
-  return ss.str();
+std::string gbhelp::decode_string(
+  std::span<const std::uint8_t> raw_data, const CharTable &charactermap,
+  std::uint8_t eos_char, DecodeReport *report
+) {
+  std::string output;
+  decode_string(raw_data, charactermap, eos_char, output, report);
+  return output;
 }
 
 void gbhelp::dump_ram(
-  Cartridge &cart, const std::filesystem::path &output_directory,
-  const std::string &name, bool create_dirs
+  std::span<const std::uint8_t> data,
+  const std::filesystem::path &output_directory, const std::string &name,
+  bool create_dirs
 ) {
-  // dump scprite scratch ram to a texture, in column order
-  std::array<std::uint8_t, 0x4000> &ram = cart.ram;
-
-  // onle need a new buffer for 3 * 392 bytes
-  std::array<std::uint8_t, 0x0498> transposed;
+  // dump sprite scratch memory to a texture, in column order
+  std::size_t num_cols = (data.size() + 55) / 56;
+  std::vector<std::uint8_t> transposed(num_cols * 56, 0);
 
-  for (std::size_t col = 0; col < 21; ++col) {
+  for (std::size_t col = 0; col < num_cols; ++col) {
     std::size_t offset = col * 56;
     for (std::size_t row = 0; row < 56; ++row) {
       std::size_t index = row + offset;
-      std::size_t transposed_index = col + (row * 21);
+      std::size_t transposed_index = col + (row * num_cols);
 
-      transposed[transposed_index] = ram[index];
+      if (index < data.size()) {
+        transposed[transposed_index] = data[index];
+      }
     }
   }
 
@@ -84,5 +96,5 @@ void gbhelp::dump_ram(
   std::stringstream ss;
   ss << name << ".pgm";
   std::filesystem::path filepath = output_directory / ss.str();
-  save_pgm(image_data, 168, 56, filepath, true, "1");
+  save_pgm(image_data, num_cols * 8, 56, filepath, create_dirs, "1");
 }
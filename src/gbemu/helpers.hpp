@@ -1,14 +1,15 @@
 #ifndef __GBEMU_HELPERS__
 #define __GBEMU_HELPERS__
 
+#include <array>
 #include <filesystem>
-#include <map>
+#include <span>
 #include <string>
+#include <string_view>
 #include <vector>
 
 #include <cstdint>
 
-#include "cartridge.hpp"
 
 namespace gbhelp {
   std::string hex_str(
@@ -19,15 +20,32 @@ namespace gbhelp {
     std::uint8_t bank, std::uint16_t offset, std::uint16_t bank_size=0x4000
   );
 
+  // text encoding of a rom, an empty entry marks an unknown character
+  using CharTable = std::array<std::string_view, 256>;
+
+  // characters the table had no entry for, per byte value
+  struct DecodeReport {
+    std::size_t unknown_total = 0;
+    std::array<std::size_t, 256> unknown {};
+  };
+
+  // append the text up to eos_char (or the end of raw_data) to output,
+  // unknown characters are written as a dot and counted in the report
+  void decode_string(
+    std::span<const std::uint8_t> raw_data, const CharTable &charactermap,
+    std::uint8_t eos_char, std::string &output, DecodeReport *report=nullptr
+  );
+
   std::string decode_string(
-    const std::vector<std::uint8_t> &raw_data,
-    const std::map<std::uint8_t, std::string> &charactermap,
-    std::uint8_t eos_char
+    std::span<const std::uint8_t> raw_data, const CharTable &charactermap,
+    std::uint8_t eos_char, DecodeReport *report=nullptr
   );
 
+  // render a block of sprite memory to a texture, 56 byte columns
   void dump_ram(
-    Cartridge &cart, const std::filesystem::path &output_directory,
-    const std::string &name, bool create_dirs=false
+    std::span<const std::uint8_t> data,
+    const std::filesystem::path &output_directory, const std::string &name,
+    bool create_dirs=false
   );
 }
 
@@ -0,0 +1,41 @@
+#include <algorithm>
+#include <tuple>
+
+#include "jobplan.hpp"
+
+std::vector<pkmnred::SpriteJob> pkmnred::plan_jobs(
+  const RomIndex &rom_index, std::span<const std::uint8_t> pokemon_ids,
+  std::size_t window
+) {
+  std::vector<SpriteJob> jobs;
+  jobs.reserve(pokemon_ids.size());
+
+  for (std::size_t row = 0; row < pokemon_ids.size(); ++row) {
+    std::uint8_t id = pokemon_ids[row];
+
+    if (rom_index.contains(id)) {
+      jobs.push_back({
+        row, id, rom_index.sprite_bank(id), rom_index.front_sprite_offset(id)
+      });
+    } else {
+      jobs.push_back({row, id, 0, 0});
+    }
+  }
+
+  if (window == 0) {
+    window = jobs.size();
+  }
+
+  // the row breaks ties, sprites shared between pokemon stay in input order
+  auto by_bank = [](const SpriteJob &a, const SpriteJob &b) {
+    return std::tie(a.bank, a.offset, a.row) <
+      std::tie(b.bank, b.offset, b.row);
+  };
+
+  for (std::size_t start = 0; start < jobs.size(); start += window) {
+    std::size_t end = std::min(start + window, jobs.size());
+    std::sort(jobs.begin() + start, jobs.begin() + end, by_bank);
+  }
+
+  return jobs;
+}
@@ -0,0 +1,34 @@
+#ifndef __POKEMON_RED_JOBPLAN__
+#define __POKEMON_RED_JOBPLAN__
+
+#include <span>
+#include <vector>
+
+#include <cstdint> // std::uint8_t, std::uint16_t
+
+#include "romindex.hpp"
+
+namespace pkmnred {
+  struct SpriteJob {
+    std::size_t row;          // position in the input, where the output goes
+    std::uint8_t pokemon_id;
+    std::uint8_t bank;
+    std::uint16_t offset;     // front sprite
+  };
+
+  // The order to decode a batch of pokemon in. Jobs are grouped by sprite
+  // bank and sorted by offset inside it, so every bank is read front to
+  // back, whether one thread works through the list or several take jobs
+  // from it in turn. Ids the index does not know come first, they fail
+  // straight away.
+  //
+  // A window other than 0 only sorts runs of that many input rows, the runs
+  // stay in input order. Rows reported in input order then wait on at most
+  // one window instead of on the last bank of the whole batch.
+  std::vector<SpriteJob> plan_jobs(
+    const RomIndex &rom_index, std::span<const std::uint8_t> pokemon_ids,
+    std::size_t window=0
+  );
+}
+
+#endif // __POKEMON_RED_JOBPLAN__
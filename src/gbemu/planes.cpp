@@ -0,0 +1,87 @@
+#include <cstring> // std::memcpy, std::memset
+
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#endif
+
+#include "planes.hpp"
+
+std::uint8_t *gbemu::PlaneBuffer::plane(std::size_t index) {
+  return &data[index * PLANE_STRIDE];
+}
+
+const std::uint8_t *gbemu::PlaneBuffer::plane(std::size_t index) const {
+  return &data[index * PLANE_STRIDE];
+}
+
+void gbemu::planes::clear(std::uint8_t *dst) {
+  std::memset(dst, 0, PLANE_STRIDE);
+}
+
+void gbemu::planes::copy(std::uint8_t *dst, const std::uint8_t *src) {
+  std::memcpy(dst, src, PLANE_STRIDE);
+}
+
+void gbemu::planes::xor_into(std::uint8_t *dst, const std::uint8_t *src) {
+  std::size_t i = 0;
+
+#if defined(__SSE2__)
+  for (; i + 16 <= PLANE_STRIDE; i += 16) {
+    __m128i a = _mm_load_si128(reinterpret_cast<const __m128i *>(dst + i));
+    __m128i b = _mm_load_si128(reinterpret_cast<const __m128i *>(src + i));
+    _mm_store_si128(reinterpret_cast<__m128i *>(dst + i), _mm_xor_si128(a, b));
+  }
+#endif
+
+  for (; i < PLANE_STRIDE; ++i) {
+    dst[i] ^= src[i];
+  }
+}
+
+void gbemu::planes::interleave(
+  std::span<std::uint8_t, SPRITE_SIZE> out, const std::uint8_t *low,
+  const std::uint8_t *high
+) {
+  finalise(out, low, high, false, false);
+}
+
+void gbemu::planes::finalise(
+  std::span<std::uint8_t, SPRITE_SIZE> out, const std::uint8_t *low,
+  const std::uint8_t *high, bool xor_low, bool xor_high
+) {
+  std::size_t i = 0;
+
+#if defined(__SSE2__)
+  // all ones selects the XOR, all zeros leaves the plane as it is
+  const __m128i low_mask = _mm_set1_epi8(xor_low ? -1 : 0);
+  const __m128i high_mask = _mm_set1_epi8(xor_high ? -1 : 0);
+
+  for (; i + 16 <= PLANE_SIZE; i += 16) {
+    __m128i a = _mm_load_si128(reinterpret_cast<const __m128i *>(low + i));
+    __m128i b = _mm_load_si128(reinterpret_cast<const __m128i *>(high + i));
+
+    a = _mm_xor_si128(a, _mm_and_si128(b, low_mask));
+    b = _mm_xor_si128(b, _mm_and_si128(a, high_mask));
+
+    // out belongs to the caller and need not be aligned
+    __m128i *dst = reinterpret_cast<__m128i *>(&out[i * 2]);
+    _mm_storeu_si128(dst, _mm_unpacklo_epi8(a, b));
+    _mm_storeu_si128(dst + 1, _mm_unpackhi_epi8(a, b));
+  }
+#endif
+
+  for (; i < PLANE_SIZE; ++i) {
+    std::uint8_t a = low[i];
+    std::uint8_t b = high[i];
+
+    if (xor_low) {
+      a ^= b;
+    }
+    if (xor_high) {
+      b ^= a;
+    }
+
+    out[i * 2] = a;
+    out[(i * 2) + 1] = b;
+  }
+}
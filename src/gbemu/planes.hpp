@@ -0,0 +1,54 @@
+#ifndef __GBEMU_PLANES_HPP__
+#define __GBEMU_PLANES_HPP__
+
+#include <array>
+#include <span>
+
+#include <cstdint> // std::size_t, std::uint8_t
+
+namespace gbemu {
+  // largest sprite in either direction, in tiles
+  constexpr std::uint8_t MAX_SPRITE_TILES = 7;
+  // one bitplane of the largest sprite, 7x7 tiles of 8 bytes
+  constexpr std::size_t PLANE_SIZE = 392;
+  // planes are padded out to a whole number of cache lines
+  constexpr std::size_t PLANE_STRIDE = 448;
+  // both planes interleaved, low byte first (the layout Renderer expects)
+  constexpr std::size_t SPRITE_SIZE = PLANE_SIZE * 2;
+
+  // Sprite decode scratch: three bitplanes, each one starting on its own
+  // cache line. Plane 0 is spare, planes 1 and 2 hold the low and high bits
+  // of the sprite.
+  struct alignas(64) PlaneBuffer {
+    std::uint8_t *plane(std::size_t index);
+    const std::uint8_t *plane(std::size_t index) const;
+
+    std::array<std::uint8_t, PLANE_STRIDE * 3> data {};
+  };
+
+  // Kernels work on whole planes (PLANE_STRIDE bytes, including the padding)
+  // from a PlaneBuffer, so plane reads and writes are aligned. interleave
+  // and finalise only read the PLANE_SIZE bytes that hold data, and write
+  // to a caller's buffer that need not be aligned.
+  namespace planes {
+    void clear(std::uint8_t *dst);
+    void copy(std::uint8_t *dst, const std::uint8_t *src);
+    void xor_into(std::uint8_t *dst, const std::uint8_t *src);
+
+    // out[i * 2] = low[i], out[(i * 2) + 1] = high[i]
+    void interleave(
+      std::span<std::uint8_t, SPRITE_SIZE> out, const std::uint8_t *low,
+      const std::uint8_t *high
+    );
+
+    // interleave, optionally XOR-ing one plane into the other on the way
+    // through. xor_low: low ^= high, xor_high: high ^= low. The planes
+    // themselves are left untouched.
+    void finalise(
+      std::span<std::uint8_t, SPRITE_SIZE> out, const std::uint8_t *low,
+      const std::uint8_t *high, bool xor_low, bool xor_high
+    );
+  }
+}
+
+#endif // __GBEMU_PLANES_HPP__
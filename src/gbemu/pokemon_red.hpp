@@ -1,13 +1,14 @@
 #ifndef __POKEMON_RED__
 #define __POKEMON_RED__
 
-#include <map>
 #include <string>
+#include <string_view>
 #include <vector>
 
 #include <cstdint> // std::uint8_t, std::uint16_t
 
 #include "cartridge.hpp"
+#include "helpers.hpp"
 
 namespace pkmnred {
   // general header
@@ -25,6 +26,46 @@ namespace pkmnred {
 
   constexpr std::uint8_t eos_char = 0x50;
 
+  constexpr gbhelp::CharTable make_charmap() {
+    // single characters are views into these, in rom order
+    constexpr std::string_view uppercase = "ABCDEFGHIJKLMNOPQRSTUVWXYZ[";
+    constexpr std::string_view lowercase = "abcdefghijklmnopqrstuvwxyz{";
+    constexpr std::string_view digits = "0123456789";
+
+    gbhelp::CharTable charmap {};
+
+    for (std::size_t i = 0; i < uppercase.size(); ++i) {
+      charmap[0x80 + i] = uppercase.substr(i, 1);
+    }
+    for (std::size_t i = 0; i < lowercase.size(); ++i) {
+      charmap[0xa0 + i] = lowercase.substr(i, 1);
+    }
+    for (std::size_t i = 0; i < digits.size(); ++i) {
+      charmap[0xf6 + i] = digits.substr(i, 1);
+    }
+
+    charmap[0x50] = "⋄";
+
+    charmap[0x00] = "⋄";
+    charmap[0x49] = "\n"; // next page token?
+    charmap[0x4e] = "\n";
+    charmap[0x54] = "Poké";
+    charmap[0x5f] = ".";  // ??
+    charmap[0x7f] = " ";
+    charmap[0xbd] = "'s";
+    charmap[0xbe] = "'t";
+    charmap[0xe0] = "'";
+    charmap[0xe3] = "-";
+    charmap[0xe8] = ".";
+    charmap[0xef] = "♂";
+    charmap[0xf4] = ",";
+    charmap[0xf5] = "♀";
+
+    return charmap;
+  }
+
+  constexpr gbhelp::CharTable charmap = make_charmap();
+
   /////////////////////////////////////////////////////////////////////////////
   //
   constexpr std::uint8_t minimum_index = 0x01;
@@ -127,12 +168,9 @@ namespace pkmnred {
   /////////////////////////////////////////////////////////////////////////////
   // hacks
 
-  // can't find any table for the move names, so they will be automatically
-  // loaded and stored in the ram, located directly after
-
-  // pointers to null-terminated strings (variable width)
+  // can't find any table for the move names, so RomIndex walks the
+  // null-terminated strings once and keeps the offsets
   constexpr std::uint16_t move_names_pointer_bank   = 0x2c;
-  constexpr std::uint16_t move_names_pointer_offset = 0xa498;
 
   /////////////////////////////////////////////////////////////////////////////
   // ram addresses
@@ -152,6 +190,7 @@ namespace pkmnred {
     std::uint8_t catch_rate;
     std::uint8_t exp_yield;
     std::uint8_t sprite_size;
+    std::uint8_t sprite_bank;
     std::uint16_t front_sprite_offset;
     std::uint16_t back_sprite_offset;
     std::uint8_t move_1_index;
@@ -194,10 +233,6 @@ namespace pkmnred {
     std::string name;
   };
 
-  PokemonStats get_stats(std::uint8_t pokemon_id, Cartridge &cart);
-
-  void load_move_names(Cartridge &cart);
-  std::map<std::uint8_t, std::string> get_charmap();
 
   std::ostream &operator<<(std::ostream &os, const PokemonStats &stats);
 }
@@ -0,0 +1,108 @@
+#include <algorithm>
+#include <array>
+#include <bit>
+#include <cstring> // std::memcpy
+
+#include "rasteriser.hpp"
+
+namespace {
+  constexpr std::size_t TILES = 7;
+
+  // every bit of a byte spread out into its own byte, leftmost pixel first
+  // in memory
+  constexpr std::array<std::uint64_t, 256> make_spread_table() {
+    std::array<std::uint64_t, 256> table {};
+
+    for (std::size_t b = 0; b < 256; ++b) {
+      std::uint64_t pixels = 0;
+
+      for (std::size_t i = 0; i < 8; ++i) {
+        std::size_t shift = (std::endian::native == std::endian::little)
+          ? (i * 8) : ((7 - i) * 8);
+
+        pixels |= std::uint64_t((b >> (7 - i)) & 0b1) << shift;
+      }
+
+      table[b] = pixels;
+    }
+
+    return table;
+  }
+
+  constexpr std::array<std::uint64_t, 256> spread = make_spread_table();
+}
+
+void gbemu::rasterise(
+  std::span<const std::uint8_t> tiles, std::uint8_t width,
+  std::uint8_t height, std::span<std::uint8_t, RASTER_SIZE> output
+) {
+  std::fill(output.begin(), output.end(), 0x00);
+
+  std::size_t visible_width = std::min<std::size_t>(width, TILES);
+  std::size_t visible_height = std::min<std::size_t>(height, TILES);
+
+  // same rounding as add_padding(), odd gaps put the extra column on the left
+  std::size_t pad_left = (TILES - visible_width + 1) / 2;
+  std::size_t pad_top = TILES - visible_height;
+
+  std::size_t num_rows = height * 8;
+
+  for (std::size_t col = 0; col < visible_width; ++col) {
+    for (std::size_t row = 0; row < (visible_height * 8); ++row) {
+      std::size_t index = ((col * num_rows) + row) * 2;
+      if (index + 1 >= tiles.size()) {
+        return;
+      }
+
+      std::uint64_t pixels = spread[tiles[index]];
+      pixels |= spread[tiles[index + 1]] << 1;
+
+      std::size_t y = (pad_top * 8) + row;
+      std::size_t x = (pad_left + col) * 8;
+      std::memcpy(&output[(y * RASTER_WIDTH) + x], &pixels, sizeof(pixels));
+    }
+  }
+}
+
+void gbemu::rasterise_doubled(
+  std::span<const std::uint8_t> tiles, std::uint8_t width,
+  std::uint8_t height, std::span<std::uint8_t, RASTER_SIZE> output
+) {
+  std::fill(output.begin(), output.end(), 0x00);
+
+  // source pixels that end up inside the box
+  std::size_t visible_width = std::min<std::size_t>(
+    width * 8, RASTER_WIDTH / 2
+  );
+  std::size_t visible_height = std::min<std::size_t>(
+    height * 8, RASTER_HEIGHT / 2
+  );
+
+  std::size_t num_rows = height * 8;
+
+  for (std::size_t row = 0; row < visible_height; ++row) {
+    std::uint8_t *line = &output[(row * 2) * RASTER_WIDTH];
+
+    for (std::size_t col = 0; col < visible_width; col += 8) {
+      std::size_t index = (((col / 8) * num_rows) + row) * 2;
+      if (index + 1 >= tiles.size()) {
+        return;
+      }
+
+      std::uint64_t pixels = spread[tiles[index]];
+      pixels |= spread[tiles[index + 1]] << 1;
+
+      std::uint8_t unpacked[8];
+      std::memcpy(unpacked, &pixels, sizeof(pixels));
+
+      std::size_t count = std::min<std::size_t>(8, visible_width - col);
+      for (std::size_t i = 0; i < count; ++i) {
+        line[(col + i) * 2] = unpacked[i];
+        line[((col + i) * 2) + 1] = unpacked[i];
+      }
+    }
+
+    // and the same line again below it
+    std::memcpy(line + RASTER_WIDTH, line, RASTER_WIDTH);
+  }
+}
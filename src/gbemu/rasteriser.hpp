@@ -0,0 +1,35 @@
+#ifndef __GBEMU_RASTERISER_HPP__
+#define __GBEMU_RASTERISER_HPP__
+
+#include <span>
+
+#include <cstdint> // std::size_t, std::uint8_t
+
+namespace gbemu {
+  // sprites are drawn into a 7x7 tile (56x56 pixel) box
+  constexpr std::size_t RASTER_WIDTH = 56;
+  constexpr std::size_t RASTER_HEIGHT = 56;
+  constexpr std::size_t RASTER_SIZE = RASTER_WIDTH * RASTER_HEIGHT;
+
+  // Single pass equivalent of Renderer::interlace(), expand(), add_padding()
+  // and transpose(). Takes zipped 2bpp tile columns (low byte, high byte for
+  // every 8 pixel row, see Decoder::finalise()) and writes one byte per
+  // pixel, row-major, into the caller's buffer. The sprite is centred
+  // horizontally and sits on the bottom of the box; tiles outside the box are
+  // cropped.
+  void rasterise(
+    std::span<const std::uint8_t> tiles, std::uint8_t width,
+    std::uint8_t height, std::span<std::uint8_t, RASTER_SIZE> output
+  );
+
+  // Back sprites are 4x4 tiles and the game draws them at twice the size
+  // (ScaleSpriteByTwo). The sprite is taken from the top left corner, every
+  // pixel becomes 2x2 and whatever does not fit in the box is cropped, so
+  // the right and bottom 4 pixels of a 4x4 sprite are lost like in the game.
+  void rasterise_doubled(
+    std::span<const std::uint8_t> tiles, std::uint8_t width,
+    std::uint8_t height, std::span<std::uint8_t, RASTER_SIZE> output
+  );
+}
+
+#endif // __GBEMU_RASTERISER_HPP__
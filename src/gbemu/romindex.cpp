@@ -0,0 +1,331 @@
+#include <algorithm>
+#include <exception>
+#include <sstream>
+
+#include "helpers.hpp"
+
+#include "romindex.hpp"
+
+namespace {
+  constexpr std::size_t pokedex_data_width = 9;
+  constexpr std::size_t stats_width = 28;
+}
+
+void pkmnred::RomIndex::build(
+  const Cartridge &cart, const RomProfile &profile
+) {
+  rom_profile = profile;
+  report = {};
+
+  std::uint8_t first_id = profile.minimum_index;
+  std::uint8_t last_id = profile.maximum_index;
+
+  valid.fill(false);
+  dex_numbers.fill(0);
+  dex_ids.fill(0);
+  stats_table.assign(id_count * stats_width, 0);
+  names.assign(id_count, "");
+  type_names.assign(256, "");
+  move_names.assign(256, "----");
+  pokedex_type_names.assign(id_count, "");
+  pokedex_entries.assign(id_count, "");
+  pokedex_data.assign(id_count * pokedex_data_width, 0);
+
+  const std::vector<std::uint8_t> &missing = profile.missingno;
+  for (std::size_t id = first_id; id <= last_id; ++id) {
+    valid[id] = (
+      std::find(missing.begin(), missing.end(), id) == missing.end()
+    );
+  }
+
+  // pokedex numbers
+  const TableLocation &order = profile.pokedex_order_table;
+  for (std::size_t id = first_id; id <= last_id; ++id) {
+    if (!valid[id]) {
+      continue;
+    }
+
+    std::uint8_t dexno = cart.read_at(
+      order.bank, order.offset + ((id - 1) * order.width)
+    );
+    if ((dexno == 0) || (dexno > profile.dex_count)) {
+      valid[id] = false;
+      continue;
+    }
+
+    dex_numbers[id] = dexno;
+    dex_ids[dexno] = id;
+  }
+
+  // base stats, one linear pass over the table
+  const TableLocation &stats_location = profile.pokemon_stats_table;
+  for (std::size_t id = first_id; id <= last_id; ++id) {
+    if (!valid[id] || (dex_numbers[id] == profile.separate_stats_dexno)) {
+      continue;
+    }
+
+    std::span<const std::uint8_t> row = cart.read_from_table_at(
+      stats_location.bank, stats_location.offset, dex_numbers[id] - 1,
+      stats_location.width
+    );
+    std::copy(
+      row.begin(), row.begin() + stats_width,
+      stats_table.begin() + (id * stats_width)
+    );
+  }
+
+  // MEW
+  std::uint8_t separate_id = dex_ids[profile.separate_stats_dexno];
+  if ((profile.separate_stats_dexno != 0) && (separate_id != 0)) {
+    const TableLocation &separate = profile.separate_stats_table;
+    std::span<const std::uint8_t> row = cart.read_from_table_at(
+      separate.bank, separate.offset, 0, separate.width
+    );
+    std::copy(
+      row.begin(), row.begin() + stats_width,
+      stats_table.begin() + (separate_id * stats_width)
+    );
+  }
+
+  for (std::size_t id = first_id; id <= last_id; ++id) {
+    const std::uint8_t *row = &stats_table[id * stats_width];
+
+    front_sprites[id] = (row[12] << 8) | row[11];
+    back_sprites[id] = (row[14] << 8) | row[13];
+  }
+
+  // names
+  const TableLocation &names_location = profile.pokemon_names_table;
+  for (std::size_t id = first_id; id <= last_id; ++id) {
+    if (!valid[id]) {
+      continue;
+    }
+
+    gbhelp::decode_string(
+      cart.read_from_table_at(
+        names_location.bank, names_location.offset, (id - 1),
+        names_location.width
+      ), charmap, eos_char, names[id], &report
+    );
+  }
+
+  // types, only the ones that are used
+  std::array<bool, 256> type_read {};
+  const TableLocation &type_names_pointers = profile.type_names_pointers;
+  for (std::size_t id = first_id; id <= last_id; ++id) {
+    if (!valid[id]) {
+      continue;
+    }
+
+    const std::uint8_t *row = &stats_table[id * stats_width];
+    for (std::uint8_t type_index : {row[6], row[7]}) {
+      if (type_read[type_index]) {
+        continue;
+      }
+      type_read[type_index] = true;
+
+      std::uint16_t offset = cart.read_address_from_table_at(
+        type_names_pointers.bank, type_names_pointers.offset, type_index
+      );
+      gbhelp::decode_string(
+        cart.read_string_at(type_names_pointers.bank, offset, eos_char),
+        charmap, eos_char,
+        type_names[type_index], &report
+      );
+    }
+  }
+
+  // moves, the names are stored back to back without a pointer table
+  std::uint16_t address = profile.move_names.offset;
+  for (std::size_t i = 0; i < profile.move_names.width; ++i) {
+    move_name_offsets[i] = address;
+
+    std::span<const std::uint8_t> s = cart.read_string_at(
+      profile.move_names.bank, address, eos_char
+    );
+    move_names[i + 1].clear();
+    gbhelp::decode_string(
+      s, charmap, eos_char, move_names[i + 1], &report
+    );
+    address += s.size();
+  }
+
+  // pokedex entries
+  for (std::size_t id = first_id; id <= last_id; ++id) {
+    if (!valid[id]) {
+      continue;
+    }
+
+    std::uint8_t bank = profile.pokedex_data_pointers.bank;
+    std::uint16_t offset = cart.read_address_from_table_at(
+      bank, profile.pokedex_data_pointers.offset, (id - 1)
+    );
+    std::span<const std::uint8_t> type_name = cart.read_string_at(
+      bank, offset, eos_char
+    );
+    gbhelp::decode_string(
+      type_name, charmap, eos_char, pokedex_type_names[id], &report
+    );
+    offset += type_name.size();
+    pokedex_data_offsets[id] = offset;
+
+    std::span<const std::uint8_t> data = cart.read_at(
+      bank, offset, pokedex_data_width
+    );
+    std::copy(
+      data.begin(), data.end(),
+      pokedex_data.begin() + (id * pokedex_data_width)
+    );
+
+    std::uint16_t entry_offset = (data[6] << 8) | data[5];
+
+    gbhelp::decode_string(
+      cart.read_string_at(
+        profile.pokedex_entries_bank, entry_offset + 1, eos_char
+      ), charmap, eos_char, pokedex_entries[id], &report
+    );
+  }
+}
+
+const pkmnred::RomProfile &pkmnred::RomIndex::profile() const {
+  return rom_profile;
+}
+
+std::size_t pkmnred::RomIndex::dex_count() const {
+  return rom_profile.dex_count;
+}
+
+void pkmnred::RomIndex::check_id(std::uint8_t pokemon_id) const {
+  if (
+    (pokemon_id < rom_profile.minimum_index) ||
+    (pokemon_id > rom_profile.maximum_index)
+  ) {
+    std::stringstream ss;
+    ss << "pokemon index " << int(pokemon_id) << " out of range.";
+    throw std::out_of_range(ss.str());
+  }
+
+  if (!valid[pokemon_id]) {
+    std::stringstream ss;
+    ss << "pokemon index " << int(pokemon_id) << " out of range. (MISSINGNO)";
+    throw std::out_of_range(ss.str());
+  }
+}
+
+bool pkmnred::RomIndex::contains(std::uint8_t pokemon_id) const {
+  return (pokemon_id < id_count) && valid[pokemon_id];
+}
+
+std::uint8_t pkmnred::RomIndex::id_from_dex(std::uint8_t dexno) const {
+  if (dexno >= dex_ids.size()) {
+    return 0;
+  }
+
+  return dex_ids[dexno];
+}
+
+std::uint8_t pkmnred::RomIndex::dexno(std::uint8_t pokemon_id) const {
+  check_id(pokemon_id);
+  return dex_numbers[pokemon_id];
+}
+
+const std::string &pkmnred::RomIndex::name(std::uint8_t pokemon_id) const {
+  check_id(pokemon_id);
+  return names[pokemon_id];
+}
+
+std::uint8_t pkmnred::RomIndex::sprite_bank(std::uint8_t pokemon_id) const {
+  check_id(pokemon_id);
+  return rom_profile.sprite_banks[pokemon_id - 1];
+}
+
+std::uint16_t pkmnred::RomIndex::front_sprite_offset(
+  std::uint8_t pokemon_id
+) const {
+  check_id(pokemon_id);
+  return front_sprites[pokemon_id];
+}
+
+std::uint16_t pkmnred::RomIndex::back_sprite_offset(
+  std::uint8_t pokemon_id
+) const {
+  check_id(pokemon_id);
+  return back_sprites[pokemon_id];
+}
+
+const gbhelp::DecodeReport &pkmnred::RomIndex::text_report() const {
+  return report;
+}
+
+const std::string &pkmnred::RomIndex::move_name(
+  std::uint8_t move_index
+) const {
+  return move_names[move_index];
+}
+
+pkmnred::PokemonStats pkmnred::RomIndex::stats(
+  std::uint8_t pokemon_id
+) const {
+  check_id(pokemon_id);
+
+  const std::uint8_t *row = &stats_table[pokemon_id * stats_width];
+  const std::uint8_t *dex = &pokedex_data[pokemon_id * pokedex_data_width];
+
+  PokemonStats stats;
+
+  stats.id = pokemon_id;
+  stats.dexno = dex_numbers[pokemon_id];
+  stats.hp = row[1];
+  stats.attack = row[2];
+  stats.defence = row[3];
+  stats.speed = row[4];
+  stats.special = row[5];
+  stats.type_1_index = row[6];
+  stats.type_2_index = row[7];
+  stats.catch_rate = row[8];
+  stats.exp_yield = row[9];
+  stats.sprite_size = row[10];
+  stats.sprite_bank = rom_profile.sprite_banks[pokemon_id - 1];
+  stats.move_1_index = row[15];
+  stats.move_2_index = row[16];
+  stats.move_3_index = row[17];
+  stats.move_4_index = row[18];
+  stats.null_byte = row[27];
+
+  stats.front_sprite_offset = front_sprites[pokemon_id];
+  stats.back_sprite_offset = back_sprites[pokemon_id];
+
+  stats.hm_and_tm_bits = 0;
+  for (std::size_t i = 0; i < 8; ++i) {
+    stats.hm_and_tm_bits <<= 8;
+    stats.hm_and_tm_bits |= row[19 + i];
+  }
+
+  stats.name = names[pokemon_id];
+  stats.type_1 = type_names[stats.type_1_index];
+  stats.type_2 = type_names[stats.type_2_index];
+
+  stats.move_1 = move_name(stats.move_1_index);
+  stats.move_2 = move_name(stats.move_2_index);
+  stats.move_3 = move_name(stats.move_3_index);
+  stats.move_4 = move_name(stats.move_4_index);
+
+  stats.pokemon_type_name = pokedex_type_names[pokemon_id];
+  stats.height_ft = dex[0];
+  stats.height_in = dex[1];
+
+  std::stringstream height_ss;
+  height_ss << int(stats.height_ft) << "' " << int(stats.height_in) << "\"";
+  stats.height_string = height_ss.str();
+
+  stats.weight = (dex[3] << 8) | dex[2];
+
+  std::stringstream weight_ss;
+  weight_ss << float(stats.weight / 10.0) << " lbs";
+  stats.weight_string = weight_ss.str();
+
+  stats.pokedex_entry_offset = (dex[6] << 8) | dex[5];
+  stats.pokedex_entry = pokedex_entries[pokemon_id];
+
+  return stats;
+}
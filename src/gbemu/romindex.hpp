@@ -0,0 +1,84 @@
+#ifndef __POKEMON_RED_ROMINDEX__
+#define __POKEMON_RED_ROMINDEX__
+
+#include <array>
+#include <string>
+#include <vector>
+
+#include <cstdint> // std::uint8_t, std::uint16_t
+
+#include "cartridge.hpp"
+#include "helpers.hpp"
+#include "pokemon_red.hpp"
+#include "romprofile.hpp"
+
+namespace pkmnred {
+  // Everything get_stats() needs, read from the rom in a single pass and
+  // stored column-wise, indexed by internal id. After build() the index is
+  // read only, so one instance can be shared between threads.
+  class RomIndex {
+  public:
+    RomIndex() = default;
+
+    // the profile says where the tables are, a copy is kept
+    void build(const Cartridge &cart, const RomProfile &rom_profile);
+
+    const RomProfile &profile() const;
+    // how many pokedex numbers there are
+    std::size_t dex_count() const;
+
+    // throws std::out_of_range for ids outside the table and missingno
+    void check_id(std::uint8_t pokemon_id) const;
+    bool contains(std::uint8_t pokemon_id) const;
+
+    // returns 0 if no pokemon has that number
+    std::uint8_t id_from_dex(std::uint8_t dexno) const;
+
+    std::uint8_t dexno(std::uint8_t pokemon_id) const;
+    const std::string &name(std::uint8_t pokemon_id) const;
+    std::uint8_t sprite_bank(std::uint8_t pokemon_id) const;
+    std::uint16_t front_sprite_offset(std::uint8_t pokemon_id) const;
+    std::uint16_t back_sprite_offset(std::uint8_t pokemon_id) const;
+
+    // "----" for empty slots and unknown moves
+    const std::string &move_name(std::uint8_t move_index) const;
+
+    // characters build() could not decode
+    const gbhelp::DecodeReport &text_report() const;
+
+    // assemble the full record for one pokemon
+    PokemonStats stats(std::uint8_t pokemon_id) const;
+
+  private:
+    // ids and dex numbers are single bytes, whatever the profile says
+    static constexpr std::size_t id_count = 256;
+
+    RomProfile rom_profile;
+
+    std::array<bool, id_count> valid {};
+    std::array<std::uint8_t, id_count> dex_numbers {};
+    std::array<std::uint8_t, id_count> dex_ids {};
+
+    // the first 28 bytes of each base stats row, the separate one included,
+    // by id
+    std::vector<std::uint8_t> stats_table;
+
+    std::array<std::uint16_t, id_count> front_sprites {};
+    std::array<std::uint16_t, id_count> back_sprites {};
+    std::array<std::uint16_t, id_count> pokedex_data_offsets {};
+    std::array<std::uint16_t, id_count> move_name_offsets {};
+
+    std::vector<std::string> names;
+    std::vector<std::string> type_names;
+    std::vector<std::string> move_names;
+    std::vector<std::string> pokedex_type_names;
+    std::vector<std::string> pokedex_entries;
+
+    gbhelp::DecodeReport report;
+
+    // height_ft, height_in, weight (2), unknown, entry offset (2), unknown
+    std::vector<std::uint8_t> pokedex_data;
+  };
+}
+
+#endif // __POKEMON_RED_ROMINDEX__
@@ -0,0 +1,345 @@
+#include <algorithm>
+#include <exception>
+#include <fstream>
+#include <sstream>
+
+#include "pokemon_red.hpp"
+
+#include "romprofile.hpp"
+
+namespace {
+  // numbers in profile files are always hex, with or without 0x
+  std::uint32_t parse_hex(const std::string &token, std::uint32_t max) {
+    std::string digits = token;
+    if ((digits.size() > 2) && (digits[0] == '0') && (digits[1] == 'x')) {
+      digits = digits.substr(2);
+    }
+
+    if (
+      digits.empty() || (digits.size() > 8) ||
+      (digits.find_first_not_of("0123456789abcdefABCDEF") != std::string::npos)
+    ) {
+      throw std::invalid_argument("not a hex number: " + token);
+    }
+
+    std::uint32_t value = std::stoul(digits, nullptr, 16);
+    if (value > max) {
+      throw std::invalid_argument("value out of range: " + token);
+    }
+
+    return value;
+  }
+
+  // bank:offset, followed by the width for tables
+  pkmnred::TableLocation parse_location(
+    const std::vector<std::string> &values, std::size_t first,
+    bool has_width
+  ) {
+    if (values.size() != first + (has_width ? 2 : 1)) {
+      throw std::invalid_argument("wrong number of values");
+    }
+
+    const std::string &location = values[first];
+    std::size_t colon = location.find(':');
+    if (colon == std::string::npos) {
+      throw std::invalid_argument("expected bank:offset, got " + location);
+    }
+
+    pkmnred::TableLocation table;
+    table.bank = parse_hex(location.substr(0, colon), 0xff);
+    table.offset = parse_hex(location.substr(colon + 1), 0xffff);
+    if (has_width) {
+      table.width = parse_hex(values[first + 1], 0xff);
+    }
+
+    return table;
+  }
+
+  void parse_value(
+    pkmnred::RomProfile &profile, const std::string &key,
+    const std::vector<std::string> &values, const std::string &text
+  ) {
+    auto expect = [&](std::size_t count) {
+      if (values.size() != count) {
+        throw std::invalid_argument("wrong number of values for " + key);
+      }
+    };
+
+    if (key == "title") {
+      if (text.empty() || (text.size() > pkmnred::title_length)) {
+        throw std::invalid_argument("title must be 1 to 16 characters");
+      }
+      profile.title = text;
+    } else if (key == "checksum") {
+      expect(1);
+      profile.has_checksum = true;
+      profile.global_checksum = parse_hex(values[0], 0xffff);
+    } else if (key == "index_range") {
+      expect(2);
+      profile.minimum_index = parse_hex(values[0], 0xff);
+      profile.maximum_index = parse_hex(values[1], 0xff);
+    } else if (key == "dex_count") {
+      expect(1);
+      profile.dex_count = parse_hex(values[0], 0xff);
+    } else if ((key == "missingno") || (key == "sprite_banks")) {
+      // long lists can be split over several lines
+      std::vector<std::uint8_t> &list = (key == "missingno")
+        ? profile.missingno : profile.sprite_banks;
+      for (auto &v : values) {
+        list.push_back(parse_hex(v, 0xff));
+      }
+    } else if (key == "type_names") {
+      profile.type_names_pointers = parse_location(values, 0, false);
+    } else if (key == "pokedex_data") {
+      profile.pokedex_data_pointers = parse_location(values, 0, false);
+    } else if (key == "pokemon_stats") {
+      profile.pokemon_stats_table = parse_location(values, 0, true);
+    } else if (key == "separate_stats") {
+      if (values.empty()) {
+        throw std::invalid_argument("wrong number of values for " + key);
+      }
+      profile.separate_stats_dexno = parse_hex(values[0], 0xff);
+      profile.separate_stats_table = parse_location(values, 1, true);
+    } else if (key == "pokedex_order") {
+      profile.pokedex_order_table = parse_location(values, 0, true);
+    } else if (key == "pokemon_names") {
+      profile.pokemon_names_table = parse_location(values, 0, true);
+    } else if (key == "move_names") {
+      profile.move_names = parse_location(values, 0, true);
+    } else if (key == "pokedex_entries") {
+      expect(1);
+      profile.pokedex_entries_bank = parse_hex(values[0], 0xff);
+    } else {
+      throw std::invalid_argument("unknown key " + key);
+    }
+  }
+
+  // the parts of a profile RomIndex relies on
+  std::string check_profile(const pkmnred::RomProfile &profile) {
+    if (profile.title.empty()) {
+      return "no title";
+    }
+    if (
+      (profile.minimum_index == 0) ||
+      (profile.maximum_index < profile.minimum_index)
+    ) {
+      return "bad index_range";
+    }
+    if (profile.sprite_banks.size() != profile.maximum_index) {
+      return "sprite_banks needs one bank for every id up to the maximum";
+    }
+    if (profile.dex_count == 0) {
+      return "dex_count is 0";
+    }
+    if (profile.pokemon_stats_table.width < 28) {
+      return "pokemon_stats rows are 28 bytes or more";
+    }
+    if (
+      (profile.separate_stats_dexno != 0) &&
+      (profile.separate_stats_table.width < 28)
+    ) {
+      return "separate_stats rows are 28 bytes or more";
+    }
+    if (
+      (profile.pokedex_order_table.width == 0) ||
+      (profile.pokemon_names_table.width == 0)
+    ) {
+      return "table width is 0";
+    }
+    if (profile.move_names.width == 0) {
+      return "move_names needs a move count";
+    }
+
+    return "";
+  }
+}
+
+pkmnred::RomProfile pkmnred::red_profile() {
+  RomProfile profile;
+
+  profile.name = name_string;
+  for (std::uint8_t c : name) {
+    if (c == 0) {
+      break;
+    }
+    profile.title.push_back(c);
+  }
+
+  profile.minimum_index = minimum_index;
+  profile.maximum_index = maximum_index;
+  profile.dex_count = dex_to_index.size();
+  profile.missingno = missingno;
+  profile.sprite_banks = sprite_banks;
+
+  profile.type_names_pointers = {
+    type_names_pointer_bank, type_names_pointer_offset, 2
+  };
+  profile.pokedex_data_pointers = {
+    pokedex_data_pointer_bank, pokedex_data_pointer_offset, 2
+  };
+  profile.pokemon_stats_table = {
+    pokemon_stats_table_bank, pokemon_stats_table_offset,
+    pokemon_stats_table_width
+  };
+  profile.pokedex_order_table = {
+    pokedex_order_table_bank, pokedex_order_table_offset,
+    pokedex_order_table_width
+  };
+  profile.pokemon_names_table = {
+    pokemon_names_table_bank, pokemon_names_table_offset,
+    pokemon_names_table_width
+  };
+
+  profile.separate_stats_dexno = 151;
+  profile.separate_stats_table = {
+    mew_stats_table_bank, mew_stats_table_offset, mew_stats_table_width
+  };
+
+  profile.move_names = {move_names_pointer_bank, 0x4000, 165};
+  profile.pokedex_entries_bank = 0x2b;
+
+  return profile;
+}
+
+std::string pkmnred::header_title(const Cartridge &cart) {
+  std::string title;
+
+  for (std::size_t i = 0; i < title_length; ++i) {
+    std::size_t address = title_address + i;
+    if ((address >= cart.bank0.size()) || (cart.bank0[address] == 0)) {
+      break;
+    }
+    if (cart.bank0[address] >= 0x80) {
+      break;
+    }
+
+    title.push_back(cart.bank0[address]);
+  }
+
+  return title;
+}
+
+std::uint16_t pkmnred::header_checksum(const Cartridge &cart) {
+  if (cart.bank0.size() < global_checksum_address + 2) {
+    return 0;
+  }
+
+  // the only big endian value in the header
+  return (
+    (cart.bank0[global_checksum_address] << 8) |
+    cart.bank0[global_checksum_address + 1]
+  );
+}
+
+pkmnred::ProfileRegistry::ProfileRegistry() : known({red_profile()}) {}
+
+std::size_t pkmnred::ProfileRegistry::load(
+  const std::filesystem::path &path
+) {
+  std::ifstream ifs(path);
+  if (!ifs.is_open()) {
+    std::stringstream ss;
+    ss << "unable to open profile file " << path;
+    throw std::runtime_error(ss.str());
+  }
+
+  auto error = [&](std::size_t line_number, const std::string &message) {
+    std::stringstream ss;
+    ss << path.string() << ":" << line_number << ": " << message;
+    return std::runtime_error(ss.str());
+  };
+
+  std::vector<RomProfile> loaded;
+  std::vector<std::size_t> first_lines;
+
+  std::string line;
+  std::size_t line_number = 0;
+  while (std::getline(ifs, line)) {
+    ++line_number;
+
+    line = line.substr(0, line.find('#'));
+    std::size_t start = line.find_first_not_of(" \t\r");
+    if (start == std::string::npos) {
+      continue;
+    }
+    line = line.substr(start, line.find_last_not_of(" \t\r") + 1 - start);
+
+    if (line[0] == '[') {
+      if ((line.back() != ']') || (line.size() < 3)) {
+        throw error(line_number, "expected [profile name]");
+      }
+
+      loaded.push_back({});
+      loaded.back().name = line.substr(1, line.size() - 2);
+      first_lines.push_back(line_number);
+      continue;
+    }
+
+    if (loaded.empty()) {
+      throw error(line_number, "value outside of a [profile]");
+    }
+
+    std::stringstream ss(line);
+    std::string key;
+    ss >> key;
+
+    std::vector<std::string> values;
+    for (std::string v; ss >> v;) {
+      values.push_back(v);
+    }
+
+    // the title is the rest of the line, spaces and all
+    std::string text;
+    std::size_t text_start = line.find_first_not_of(" \t", key.size());
+    if (text_start != std::string::npos) {
+      text = line.substr(text_start);
+    }
+
+    try {
+      parse_value(loaded.back(), key, values, text);
+    } catch (std::invalid_argument &e) {
+      throw error(line_number, e.what());
+    } catch (std::out_of_range &e) {
+      throw error(line_number, e.what());
+    }
+  }
+
+  for (std::size_t i = 0; i < loaded.size(); ++i) {
+    std::string problem = check_profile(loaded[i]);
+    if (!problem.empty()) {
+      throw error(first_lines[i], "[" + loaded[i].name + "] " + problem);
+    }
+  }
+
+  known.insert(known.begin(), loaded.begin(), loaded.end());
+  return loaded.size();
+}
+
+const pkmnred::RomProfile *pkmnred::ProfileRegistry::detect(
+  const Cartridge &cart
+) const {
+  std::string title = header_title(cart);
+  std::uint16_t checksum = header_checksum(cart);
+
+  const RomProfile *title_match = nullptr;
+  for (const RomProfile &profile : known) {
+    if (profile.title != title) {
+      continue;
+    }
+
+    if (profile.has_checksum) {
+      if (profile.global_checksum == checksum) {
+        return &profile;
+      }
+    } else if (title_match == nullptr) {
+      title_match = &profile;
+    }
+  }
+
+  return title_match;
+}
+
+const std::vector<pkmnred::RomProfile> &
+pkmnred::ProfileRegistry::profiles() const {
+  return known;
+}
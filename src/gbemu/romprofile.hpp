@@ -0,0 +1,91 @@
+#ifndef __POKEMON_RED_ROMPROFILE__
+#define __POKEMON_RED_ROMPROFILE__
+
+#include <filesystem>
+#include <string>
+#include <vector>
+
+#include <cstdint> // std::uint8_t, std::uint16_t
+
+#include "cartridge.hpp"
+
+namespace pkmnred {
+  // header fields used to recognise a rom
+  constexpr std::uint16_t title_address           = 0x0134;
+  constexpr std::uint16_t title_length            = 16;
+  constexpr std::uint16_t global_checksum_address = 0x014e;
+
+  struct TableLocation {
+    std::uint8_t bank = 0;
+    std::uint16_t offset = 0;
+    std::uint8_t width = 0;
+  };
+
+  // Where everything RomIndex reads lives in one particular build of the
+  // game. The built-in profile comes from the constants in pokemon_red.hpp,
+  // more are loaded at runtime from a profile file (see data/profiles.txt).
+  struct RomProfile {
+    std::string name;
+
+    // as header_title() reads it
+    std::string title;
+    bool has_checksum = false;
+    std::uint16_t global_checksum = 0;
+
+    std::uint8_t minimum_index = 0;
+    std::uint8_t maximum_index = 0;
+    std::uint8_t dex_count = 0;
+    std::vector<std::uint8_t> missingno;
+
+    // indexed by (id - 1)
+    std::vector<std::uint8_t> sprite_banks;
+
+    TableLocation type_names_pointers;
+    TableLocation pokedex_data_pointers;
+    TableLocation pokemon_stats_table;
+    TableLocation pokedex_order_table;
+    TableLocation pokemon_names_table;
+
+    // one pokemon whose stats are not in pokemon_stats_table (mew), 0 if
+    // there is none
+    std::uint8_t separate_stats_dexno = 0;
+    TableLocation separate_stats_table;
+
+    // move names are stored back to back, width is the number of moves
+    TableLocation move_names;
+    std::uint8_t pokedex_entries_bank = 0;
+  };
+
+  // the profile for the rom the constants in pokemon_red.hpp describe
+  RomProfile red_profile();
+
+  // The title up to the first 0. Later carts reuse the end of the title
+  // area for other fields, so anything from the first byte >= 0x80 on (e.g.
+  // the CGB flag) is not part of it either.
+  std::string header_title(const Cartridge &cart);
+  std::uint16_t header_checksum(const Cartridge &cart);
+
+  // Known rom profiles, recognised by the title in the cartridge header and,
+  // for profiles that have one, the global checksum.
+  class ProfileRegistry {
+  public:
+    // starts out with red_profile()
+    ProfileRegistry();
+
+    // Adds every profile in a profile file, in front of the ones already
+    // known, returns how many were read. Throws std::runtime_error naming
+    // the line for anything it cannot parse.
+    std::size_t load(const std::filesystem::path &path);
+
+    // A profile whose checksum and title match beats one with only a
+    // matching title, nullptr if nothing matches.
+    const RomProfile *detect(const Cartridge &cart) const;
+
+    const std::vector<RomProfile> &profiles() const;
+
+  private:
+    std::vector<RomProfile> known;
+  };
+}
+
+#endif // __POKEMON_RED_ROMPROFILE__
@@ -0,0 +1,194 @@
+#include <algorithm>
+#include <sstream>
+
+#include "../util/io.hpp"
+#include "helpers.hpp"
+
+#include "spritecache.hpp"
+
+namespace {
+  constexpr std::uint8_t CACHE_MAGIC[4] = {'P', 'K', 'S', 'C'};
+  // bump when the decoder output or the file layout changes
+  constexpr std::uint16_t CACHE_VERSION = 1;
+
+  constexpr std::size_t HEADER_SIZE = 20;
+  constexpr std::size_t RECORD_SIZE = 12;
+
+  std::uint32_t make_key(std::uint8_t bank, std::uint16_t offset) {
+    return (std::uint32_t(bank) << 16) | offset;
+  }
+
+  std::size_t tile_bytes(const gbemu::DecodedSprite &sprite) {
+    return sprite.width * sprite.height * 16;
+  }
+
+  void put_le(std::vector<std::uint8_t> &data, std::uint64_t v, std::size_t n) {
+    for (std::size_t i = 0; i < n; ++i) {
+      data.push_back((v >> (i * 8)) & 0xff);
+    }
+  }
+
+  std::uint64_t get_le(const std::uint8_t *p, std::size_t n) {
+    std::uint64_t v = 0;
+    for (std::size_t i = n; i > 0; --i) {
+      v <<= 8;
+      v |= p[i - 1];
+    }
+    return v;
+  }
+}
+
+gbemu::SpriteCache::SpriteCache(
+  const std::filesystem::path &directory, std::uint64_t fingerprint
+) : directory(directory), fingerprint(fingerprint), dirty(false) {}
+
+std::size_t gbemu::SpriteCache::load() {
+  std::lock_guard<std::mutex> lock(mutex);
+  entries.clear();
+
+  if (
+    !std::filesystem::exists(index_path()) ||
+    !std::filesystem::exists(data_path())
+  ) {
+    return 0;
+  }
+
+  std::vector<std::uint8_t> index = loadFromFile(index_path());
+  std::vector<std::uint8_t> data = loadFromFile(data_path());
+
+  if (
+    (index.size() < HEADER_SIZE) ||
+    !std::equal(CACHE_MAGIC, CACHE_MAGIC + 4, index.begin()) ||
+    (get_le(&index[4], 2) != CACHE_VERSION) ||
+    (get_le(&index[8], 8) != fingerprint)
+  ) {
+    return 0;
+  }
+
+  std::size_t count = get_le(&index[16], 4);
+  if (index.size() != HEADER_SIZE + (count * RECORD_SIZE)) {
+    return 0;
+  }
+
+  for (std::size_t i = 0; i < count; ++i) {
+    const std::uint8_t *record = &index[HEADER_SIZE + (i * RECORD_SIZE)];
+
+    DecodedSprite sprite;
+    sprite.width = record[3];
+    sprite.height = record[4];
+    sprite.encoding_mode = record[5];
+    sprite.swap_buffers = record[6];
+
+    std::size_t data_offset = get_le(&record[8], 4);
+    std::size_t size = tile_bytes(sprite);
+
+    if (
+      (sprite.width > 7) || (sprite.height > 7) ||
+      (data_offset + size > data.size())
+    ) {
+      entries.clear();
+      return 0;
+    }
+
+    std::copy(
+      data.begin() + data_offset, data.begin() + data_offset + size,
+      sprite.tiles.begin()
+    );
+
+    entries[make_key(record[0], get_le(&record[1], 2))] = sprite;
+  }
+
+  return entries.size();
+}
+
+int gbemu::SpriteCache::save() {
+  std::lock_guard<std::mutex> lock(mutex);
+
+  if (!dirty) {
+    return 0;
+  }
+
+  // sorted, so the same set of sprites always gives the same files
+  std::vector<std::uint32_t> keys;
+  for (auto &[key, sprite] : entries) {
+    keys.push_back(key);
+  }
+  std::sort(keys.begin(), keys.end());
+
+  std::vector<std::uint8_t> index(CACHE_MAGIC, CACHE_MAGIC + 4);
+  put_le(index, CACHE_VERSION, 2);
+  put_le(index, 0, 2);
+  put_le(index, fingerprint, 8);
+  put_le(index, keys.size(), 4);
+
+  std::vector<std::uint8_t> data;
+
+  for (std::uint32_t key : keys) {
+    const DecodedSprite &sprite = entries.at(key);
+
+    put_le(index, key >> 16, 1);
+    put_le(index, key & 0xffff, 2);
+    index.push_back(sprite.width);
+    index.push_back(sprite.height);
+    index.push_back(sprite.encoding_mode);
+    index.push_back(sprite.swap_buffers);
+    index.push_back(0);
+    put_le(index, data.size(), 4);
+
+    std::copy(
+      sprite.tiles.begin(), sprite.tiles.begin() + tile_bytes(sprite),
+      std::back_inserter(data)
+    );
+  }
+
+  // data first, so an index is never written without its data
+  if (writeToFile(data_path(), data, true)) {
+    return 1;
+  }
+  if (writeToFile(index_path(), index, true)) {
+    return 1;
+  }
+
+  dirty = false;
+  return 0;
+}
+
+bool gbemu::SpriteCache::find(
+  std::uint8_t bank, std::uint16_t offset, DecodedSprite &sprite
+) const {
+  std::lock_guard<std::mutex> lock(mutex);
+
+  auto it = entries.find(make_key(bank, offset));
+  if (it == entries.end()) {
+    return false;
+  }
+
+  sprite = it->second;
+  return true;
+}
+
+void gbemu::SpriteCache::insert(
+  std::uint8_t bank, std::uint16_t offset, const DecodedSprite &sprite
+) {
+  std::lock_guard<std::mutex> lock(mutex);
+
+  if (sprite.width > 7 || sprite.height > 7) {
+    return;
+  }
+
+  entries[make_key(bank, offset)] = sprite;
+  dirty = true;
+}
+
+std::size_t gbemu::SpriteCache::size() const {
+  std::lock_guard<std::mutex> lock(mutex);
+  return entries.size();
+}
+
+std::filesystem::path gbemu::SpriteCache::index_path() const {
+  return directory / (gbhelp::hex_str(fingerprint, 8, false) + ".idx");
+}
+
+std::filesystem::path gbemu::SpriteCache::data_path() const {
+  return directory / (gbhelp::hex_str(fingerprint, 8, false) + ".dat");
+}
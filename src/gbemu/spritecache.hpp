@@ -0,0 +1,55 @@
+#ifndef __GBEMU_SPRITECACHE_HPP__
+#define __GBEMU_SPRITECACHE_HPP__
+
+#include <filesystem>
+#include <mutex>
+#include <unordered_map>
+
+#include <cstdint>
+
+#include "spritedecoder.hpp"
+
+namespace gbemu {
+  // On-disk cache of decoded sprites for one ROM.
+  //
+  // Entries are keyed by (bank, offset) and stored under the ROM fingerprint
+  // in two files:
+  //   <fingerprint>.idx  header + one fixed size record per sprite
+  //   <fingerprint>.dat  the tile data of every sprite, back to back
+  // Only width * height * 16 bytes of tile data are kept per sprite.
+  //
+  // find() and insert() are safe to call from several threads.
+  class SpriteCache {
+  public:
+    SpriteCache(
+      const std::filesystem::path &directory, std::uint64_t fingerprint
+    );
+
+    // returns the number of entries loaded, a missing or stale cache is
+    // treated as empty
+    std::size_t load();
+    int save();
+
+    bool find(
+      std::uint8_t bank, std::uint16_t offset, DecodedSprite &sprite
+    ) const;
+    void insert(
+      std::uint8_t bank, std::uint16_t offset, const DecodedSprite &sprite
+    );
+
+    std::size_t size() const;
+
+  private:
+    std::filesystem::path index_path() const;
+    std::filesystem::path data_path() const;
+
+    std::filesystem::path directory;
+    std::uint64_t fingerprint;
+
+    mutable std::mutex mutex;
+    std::unordered_map<std::uint32_t, DecodedSprite> entries;
+    bool dirty;
+  };
+}
+
+#endif // __GBEMU_SPRITECACHE_HPP__
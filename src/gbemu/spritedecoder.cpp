@@ -1,35 +1,55 @@
+#include <algorithm>
+#include <iomanip>
 #include <iostream>
 #include <bitset>
 
-#include "helpers.hpp"
-
 #include "spritedecoder.hpp"
 
-gbemu::Decoder::Decoder(Cartridge &cart, int verbose_level)
-: cart(cart), rom_interface(cart.bank1), offset(0), bank(0), width(0),
-  height(0), encoding_mode(0), swap_buffers(false), primary_buffer(1),
-  secondary_buffer(2), verbose_level(verbose_level)
-{}
+namespace {
+  constexpr std::size_t bank_size = 0x4000;
+}
+
+gbemu::Decoder::Decoder(std::span<const std::uint8_t> rom, int verbose_level)
+: rom(rom), rom_interface(nullptr, 0),
+  offset(0), bank(0), width(0), height(0), encoding_mode(0),
+  swap_buffers(false), primary_buffer(1), secondary_buffer(2),
+  verbose_level(verbose_level), delta_kernel(delta::select_kernel())
+{
+  set_bank(1);
+}
 
-void gbemu::Decoder::set_bank(std::uint8_t value) {
+bool gbemu::Decoder::set_bank(std::uint8_t value) {
   bank = value;
-  cart.switch_bank(bank);
-  rom_interface.attach_buffer(cart.bank1);
+
+  // the same view Cartridge::switch_bank() gives, bank 0 included
+  std::size_t start = bank * bank_size;
+  if (start + bank_size > rom.size()) {
+    rom_interface.attach_buffer(nullptr, 0);
+    return false;
+  }
+
+  rom_interface.attach_buffer(rom.data() + start, bank_size);
+  return true;
 }
 
 void gbemu::Decoder::set_offset(std::uint16_t value) {
   offset = value;
-  rom_interface.seek((offset - 0x4000) * 8);
+  rom_interface.seek((offset - bank_size) * 8);
 }
 
-void gbemu::Decoder::read_header() {
+bool gbemu::Decoder::read_header() {
   width = rom_interface.get_nibble();
   height = rom_interface.get_nibble();
   swap_buffers = rom_interface.get();
 
-  if (swap_buffers) {
-    std::swap(primary_buffer, secondary_buffer);
-  }
+  // set every time, a decoder can be reused for more sprites in its bank
+  primary_buffer = swap_buffers ? 2 : 1;
+  secondary_buffer = swap_buffers ? 1 : 2;
+
+  return (
+    (width >= 1) && (width <= MAX_SPRITE_TILES) &&
+    (height >= 1) && (height <= MAX_SPRITE_TILES)
+  );
 }
 
 void gbemu::Decoder::read_encoding_mode() {
@@ -45,225 +65,176 @@ void gbemu::Decoder::read_encoding_mode() {
   }
 }
 
-void gbemu::Decoder::rle_decode(std::size_t plane_index) {
-  int pairs_to_read = width * height * 8 * 4;
-  int pairs_read = 0;
+gbemu::PlaneCursor::PlaneCursor(
+  std::uint8_t *plane, std::size_t num_rows, std::size_t num_pairs
+) : plane(plane), num_rows(num_rows), num_pairs(num_pairs), position(0),
+  current_row(0), current_column(0)
+{}
 
-  // each column is only 2 pixels wide
-  std::size_t current_column = 0;
-  std::size_t current_row = 0;
-  std::size_t offset = 0;
-  std::size_t buffer_offset = plane_index * 392;
+void gbemu::PlaneCursor::put(std::uint8_t pair) {
+  if (position >= num_pairs) {
+    return;
+  }
+
+  std::size_t byte_index = ((current_column / 4) * num_rows) + current_row;
+  plane[byte_index] |= pair << ((3 - (current_column % 4)) * 2);
+
+  ++position;
+  ++current_row;
+  if (current_row >= num_rows) {
+    current_row = 0;
+    ++current_column;
+  }
+}
 
+void gbemu::PlaneCursor::skip(std::size_t n) {
+  // the plane is cleared before decoding, zero pairs only move the cursor
+  position = std::min(position + n, num_pairs);
+  current_row = position % num_rows;
+  current_column = position / num_rows;
+}
+
+std::size_t gbemu::PlaneCursor::tell() const {
+  return position;
+}
+
+std::size_t gbemu::PlaneCursor::remaining() const {
+  return num_pairs - position;
+}
+
+bool gbemu::PlaneCursor::full() const {
+  return position >= num_pairs;
+}
+
+void gbemu::Decoder::rle_decode(std::size_t plane_index) {
+  // each column is only 2 pixels wide
   std::size_t num_rows = (height * 8);
+  PlaneCursor cursor(
+    scratch.plane(plane_index), num_rows, num_rows * width * 4
+  );
 
   bool packet_is_data = rom_interface.get();
-  while (true) {
-    std::vector<std::bitset<2>> pairs;
+  while (!cursor.full()) {
     std::size_t bit = rom_interface.tell();
 
     if (verbose_level >= 2) {
       std::cout << (packet_is_data ? "DATA" : "RLE") << " packet  @ ";
-      std::cout << gbhelp::hex_str(bit / 8) << "(" << bit << ")" << std::endl;
+      std::cout << "0x" << std::setw(4) << std::setfill('0') << std::hex;
+      std::cout << (bit / 8) << std::dec << std::setfill(' ');
+      std::cout << "(" << bit << ")" << std::endl;
     }
 
-    try {
-      if (packet_is_data) {
-        pairs = decode_data_packet();
-      } else {
-        pairs = decode_rle_packet();
-      }
-    } catch (std::ios_base::failure &e) {
-      break;
+    std::size_t pair_count;
+    if (packet_is_data) {
+      pair_count = decode_data_packet(cursor);
+    } else {
+      pair_count = decode_rle_packet(cursor);
     }
 
-    if (verbose_level >= 2) {
-      for (std::size_t i = 0; i < pairs.size(); ++i) {
-        std::cout << pairs[i] << " ";
+    if (rom_interface.exhausted()) {
+      if (verbose_level >= 1) {
+        std::cerr << "WARNING: Reached the end of the bank. ";
+        std::cerr << cursor.remaining() << " pairs left to read!" << std::endl;
       }
-      std::cout << std::endl;
+      break;
     }
 
-    if (pairs.size() == 0) {
+    if (pair_count == 0) {
       // sometimes got zero pairs back, should not have hapenned.
       if (verbose_level >= 1) {
         std::cerr << "WARNING: Recieved zero pairs in packet. ";
-        std::cerr << pairs_to_read << " pairs left to read!" << std::endl;
+        std::cerr << cursor.remaining() << " pairs left to read!" << std::endl;
       }
-      // break;
     }
 
-    for (std::bitset<2> p : pairs) {
-      std::size_t byte_index = buffer_offset + offset + current_row;
-
-      std::uint8_t new_byte = (p.to_ulong() & 0xff);
-      new_byte <<= (3 - (current_column % 4)) * 2;
-      cart.ram[byte_index] |= new_byte;
-      ++current_row;
-      if (current_row >= (num_rows)) {
-        current_row = 0;
-        ++current_column;
-        offset = ((current_column / 4) * num_rows);
-      }
-    }
-
-    pairs_to_read -= pairs.size();
-    pairs_read += pairs.size();
-
     if (verbose_level >= 2) {
-      std::cout << "Pairs read " << pairs_read << " (" << (pairs_read / 4.0);
-      std::cout << " Bytes)" << std::endl;
-    }
-
-    if (pairs_to_read < 0) {
-      std::size_t a = rom_interface.tell();
-      std::size_t rewind_count = (-pairs_to_read) + 1;
-      std::size_t bit_count = rewind_count * 2;
-      rom_interface.seek(a - bit_count);
-    }
-
-    if (pairs_to_read <= 0) {
-      break;
+      std::cout << "Pairs read " << cursor.tell() << " (";
+      std::cout << (cursor.tell() / 4.0) << " Bytes)" << std::endl;
     }
 
     packet_is_data = !packet_is_data;
   }
 }
 
-std::vector<std::bitset<2>> gbemu::Decoder::decode_rle_packet() {
-  bool bit = 0;
-  std::size_t bits_read = 0;
+std::size_t gbemu::Decoder::decode_rle_packet(PlaneCursor &cursor) {
+  // L is a run of ones closed by a zero, V has as many bits as L
+  std::size_t bits_read = rom_interface.count_ones() + 1;
 
+  // only the low RLE_PACKET_MAX_BITS bits of L and V are kept
   std::bitset<RLE_PACKET_MAX_BITS> l = 0;
-  do {
-    bit = rom_interface.get();
-    l <<= 1;
-    l.set(0, bit);
-
-    ++bits_read;
-  } while (bit != 0);
+  if (bits_read < RLE_PACKET_MAX_BITS) {
+    l = (1 << bits_read) - 2;
+  } else {
+    l.set();
+    l.reset(0);
+  }
   if (verbose_level >= 3) {
     std::cout << "  L == " << l << std::endl;
   }
 
-  std::bitset<RLE_PACKET_MAX_BITS> v = 0;
-  for (std::size_t i = 0; i < bits_read; ++i) {
-    bit = rom_interface.get();
-    v <<= 1;
-    v.set(0, bit);
+  if (bits_read > RLE_PACKET_MAX_BITS) {
+    rom_interface.skip(bits_read - RLE_PACKET_MAX_BITS);
+    bits_read = RLE_PACKET_MAX_BITS;
   }
+  std::bitset<RLE_PACKET_MAX_BITS> v = rom_interface.get_bits(bits_read);
   if (verbose_level >= 3) {
     std::cout << "  V == " << v << std::endl;
   }
 
   std::size_t num_pairs = l.to_ulong() + v.to_ulong() + 1;
-
-  std::vector<std::bitset<2>> pairs;
-
-  for (std::size_t i = 0; i < num_pairs; ++i) {
-    pairs.push_back({0b00});
-  }
   if (verbose_level >= 3) {
     std::cout << "  N == " << num_pairs << std::endl;
   }
 
-  return pairs;
+  // a run past the end of the plane is cut short
+  cursor.skip(num_pairs);
+
+  return num_pairs;
 }
 
-std::vector<std::bitset<2>> gbemu::Decoder::decode_data_packet() {
-  std::vector<std::bitset<2>> pairs {};
+std::size_t gbemu::Decoder::decode_data_packet(PlaneCursor &cursor) {
+  std::size_t pair_count = 0;
 
-  std::bitset<2> pair = 0;
-  while (1) {
-    pair = rom_interface.get_pair();
+  // there is no terminator after the last packet in a plane, so stop as soon
+  // as the plane is full rather than reading into the next plane's data
+  while (!cursor.full()) {
+    std::uint8_t pair = rom_interface.get_pair();
 
     if (pair == 0) {
       break;
     }
 
     if (verbose_level >= 3) {
-      std::cout << pair << " ";
+      std::cout << std::bitset<2>(pair) << " ";
     }
-    pairs.push_back(pair);
+    cursor.put(pair);
+    ++pair_count;
   };
   if (verbose_level >= 3) {
     std::cout << std::endl;
   }
 
-  return pairs;
+  return pair_count;
 }
 
 void gbemu::Decoder::delta_decode(std::size_t plane_index) {
-  std::size_t buffer_offset = plane_index * 392;
-
-  std::size_t num_cols = width;
-  std::size_t num_rows = height * 8;
-
-  for (std::size_t row = 0; row < num_rows; ++row) {
-    bool do_one = 0;
-    for (std::size_t col = 0; col < num_cols; ++col) {
-      std::size_t index = row + (col * num_rows);
-
-      std::uint8_t b = cart.ram[buffer_offset + index];
-      std::uint8_t new_byte = 0;
-
-      for (int i = 8; i > 0; --i) {
-        bool is_one = (b >> (i - 1)) & 0b1;
-
-        if (is_one) {
-          do_one = !do_one;
-        }
-
-        new_byte <<= 1;
-        if (do_one) {
-          new_byte |= 0b1;
-        }
-      }
-
-      cart.ram[buffer_offset + index] = new_byte;
-    }
-  }
-}
-
-void gbemu::Decoder::xor_planes() {
-  std::size_t buffer_1_offset = primary_buffer * 392;
-  std::size_t buffer_2_offset = secondary_buffer * 392;
-
-  std::size_t buffer_size = width * height * 8;
-  for (std::size_t i = 0; i < buffer_size; ++i) {
-    cart.ram[buffer_2_offset + i] ^= cart.ram[buffer_1_offset + i];
-  }
+  delta_kernel(scratch.plane(plane_index), height * 8, width);
 }
 
 void gbemu::Decoder::clear(std::size_t plane_index) {
-  std::size_t offset = plane_index * 392;
-
-  for (std::size_t i = 0; i < 392; ++i) {
-    cart.ram[offset + i] = 0;
-  }
+  planes::clear(scratch.plane(plane_index));
 }
 
 void gbemu::Decoder::copy(std::size_t src_plane, std::size_t dst_plane) {
-  std::size_t src_offset = src_plane * 392;
-  std::size_t dst_offset = dst_plane * 392;
-
-  for (std::size_t i = 0; i < 392; ++i) {
-    cart.ram[dst_offset + i] = cart.ram[src_offset + i];
-  }
+  planes::copy(scratch.plane(dst_plane), scratch.plane(src_plane));
 }
-//
-void gbemu::Decoder::zip_planes() {
-  std::size_t index = 1176;
-  std::size_t buffer_0_offset = 0;
-  std::size_t buffer_1_offset = 392;
-
-  std::size_t buffer_size = 392;
-  for (std::size_t i = 0; i < buffer_size; ++i) {
-    std::size_t buffer_0_index = (buffer_0_offset + (buffer_size - 1)) - i;
-    std::size_t buffer_1_index = (buffer_1_offset + (buffer_size - 1)) - i;
-    --index;
-    cart.ram[index] = cart.ram[buffer_1_index];
-    --index;
-    cart.ram[index] = cart.ram[buffer_0_index];
-  }
+
+void gbemu::Decoder::finalise(std::span<std::uint8_t, SPRITE_SIZE> output) {
+  // modes 2 and 3 XOR the primary plane into the secondary one
+  bool do_xor = (encoding_mode != 1);
+
+  planes::finalise(
+    output, scratch.plane(1), scratch.plane(2),
+    do_xor && (secondary_buffer == 1), do_xor && (secondary_buffer == 2)
+  );
 }
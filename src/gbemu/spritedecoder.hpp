@@ -1,35 +1,84 @@
 #ifndef __GBEMU_SPRITE_DECODER_HPP__
 #define __GBEMU_SPRITE_DECODER_HPP__
 
+#include <array>
+#include <span>
+
 #include <cstdint>
 
-#include "binaryinterface.hpp"
-#include "cartridge.hpp"
+#include "bitreader.hpp"
+#include "delta.hpp"
+#include "planes.hpp"
 
 namespace gbemu {
   constexpr std::size_t RLE_PACKET_MAX_BITS = 16;
 
+  // Output position inside a bitplane while it is being rle decoded. Pairs
+  // are 2 pixels wide and fill a plane column by column, top to bottom.
+  class PlaneCursor {
+  public:
+    PlaneCursor(
+      std::uint8_t *plane, std::size_t num_rows, std::size_t num_pairs
+    );
+
+    // OR a pair into the plane, pairs past the end are dropped
+    void put(std::uint8_t pair);
+    // skip over n zero pairs
+    void skip(std::size_t n);
+
+    std::size_t tell() const;
+    std::size_t remaining() const;
+    bool full() const;
+
+  private:
+    std::uint8_t *plane;
+    std::size_t num_rows;
+    std::size_t num_pairs;
+
+    std::size_t position;
+    std::size_t current_row;
+    std::size_t current_column;
+  };
+
+  // everything needed to render a sprite without decoding it again
+  struct DecodedSprite {
+    std::uint8_t width = 0;
+    std::uint8_t height = 0;
+    std::uint8_t encoding_mode = 0;
+    bool swap_buffers = false;
+    std::array<std::uint8_t, SPRITE_SIZE> tiles {};
+  };
+
+  // Sprites are read through a view of the whole rom, so a decoder never
+  // changes the cartridge it reads from and needs nothing but its own
+  // members (no allocation, no output at verbose_level 0).
   class Decoder {
   public:
-    Decoder(Cartridge &card, int verbose_level=0);
-    void set_bank(std::uint8_t value);
+    explicit Decoder(std::span<const std::uint8_t> rom, int verbose_level=0);
+    // returns false if the bank is not in the rom, nothing can be read from
+    // it then
+    bool set_bank(std::uint8_t value);
+    // a bank 1 address, 0x4000 to 0x7fff
     void set_offset(std::uint16_t value);
 
-    void read_header();
+    // returns false if the sprite is not 1 to 7 tiles in each direction,
+    // the planes only hold 7x7 tiles so nothing may be decoded after that
+    bool read_header();
     void read_encoding_mode();
     void rle_decode(std::size_t plane_index);
     void delta_decode(std::size_t plane_index);
-    void xor_planes();
     void clear(std::size_t plane_index);
     void copy(std::size_t src_plane, std::size_t dst_plane);
-    void zip_planes();
+    // XOR (modes 2 and 3) and interleave planes 1 and 2 into the output in
+    // one pass
+    void finalise(std::span<std::uint8_t, SPRITE_SIZE> output);
 
   // private:
-    std::vector<std::bitset<2>> decode_rle_packet();
-    std::vector<std::bitset<2>> decode_data_packet();
+    std::size_t decode_rle_packet(PlaneCursor &cursor);
+    std::size_t decode_data_packet(PlaneCursor &cursor);
 
-    Cartridge &cart;
-    BinaryInterface rom_interface;
+    std::span<const std::uint8_t> rom;
+    BitReader rom_interface;
     std::uint16_t offset;
     std::uint8_t bank;
 
@@ -42,6 +91,9 @@ namespace gbemu {
     std::uint8_t secondary_buffer;
 
     int verbose_level;
+    delta::Kernel delta_kernel;
+
+    PlaneBuffer scratch;
   };
 }
 
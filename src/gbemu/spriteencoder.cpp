@@ -0,0 +1,255 @@
+#include <algorithm>
+#include <atomic>
+#include <bit>
+#include <exception>
+#include <sstream>
+#include <thread>
+
+#include "spriteencoder.hpp"
+
+namespace {
+  // MSB first, the same bit order BitReader reads
+  class BitWriter {
+  public:
+    void put_bits(std::uint64_t value, std::size_t n) {
+      for (std::size_t i = n; i > 0; --i) {
+        accumulator = (accumulator << 1) | ((value >> (i - 1)) & 0b1);
+        ++pending;
+
+        if (pending == 8) {
+          bytes.push_back(accumulator);
+          accumulator = 0;
+          pending = 0;
+        }
+      }
+
+      bit_count += n;
+    }
+
+    std::vector<std::uint8_t> finish() {
+      if (pending != 0) {
+        bytes.push_back(accumulator << (8 - pending));
+        accumulator = 0;
+        pending = 0;
+      }
+
+      return std::move(bytes);
+    }
+
+    std::size_t bit_count = 0;
+
+  private:
+    std::vector<std::uint8_t> bytes;
+    std::uint8_t accumulator = 0;
+    std::size_t pending = 0;
+  };
+
+  using Plane = std::array<std::uint8_t, gbemu::PLANE_SIZE>;
+
+  // inverse of the delta kernels: every bit becomes "did the pixel change"
+  // compared to the pixel to its left, rows start from 0
+  void delta_encode(Plane &plane, std::size_t num_rows, std::size_t num_cols) {
+    for (std::size_t row = 0; row < num_rows; ++row) {
+      std::uint8_t carry = 0;
+
+      for (std::size_t col = 0; col < num_cols; ++col) {
+        std::uint8_t &b = plane[(col * num_rows) + row];
+        std::uint8_t encoded = b ^ ((b >> 1) | (carry << 7));
+        carry = b & 0b1;
+        b = encoded;
+      }
+    }
+  }
+
+  // N zero pairs as L (k - 1 ones and a zero) and V (k bits), where
+  // N = L + V + 1. k is the only size that can hold N, so this is also the
+  // shortest packet for the run.
+  void put_run(BitWriter &writer, std::size_t n) {
+    std::size_t k = std::bit_width(n + 1) - 1;
+
+    writer.put_bits((std::size_t(1) << k) - 2, k);
+    writer.put_bits((n + 1) - (std::size_t(1) << k), k);
+  }
+
+  // Packets have to alternate and data packets cannot hold a zero pair, so
+  // every run of zeros is exactly one RLE packet and everything between them
+  // one data packet. Splitting a run would need an empty data packet (two
+  // extra bits) and never makes the run itself shorter, so this split is
+  // already the smallest one.
+  void rle_encode(
+    BitWriter &writer, const Plane &plane, std::size_t num_rows,
+    std::size_t num_cols
+  ) {
+    std::size_t num_pairs = num_rows * num_cols * 4;
+
+    auto pair_at = [&](std::size_t i) -> std::uint8_t {
+      std::size_t col = i / num_rows;
+      std::size_t row = i % num_rows;
+      std::uint8_t b = plane[((col / 4) * num_rows) + row];
+      return (b >> ((3 - (col % 4)) * 2)) & 0b11;
+    };
+
+    std::size_t i = 0;
+    bool packet_is_data = (pair_at(0) != 0);
+    writer.put_bits(packet_is_data, 1);
+
+    while (i < num_pairs) {
+      if (packet_is_data) {
+        std::uint8_t pair;
+        while ((i < num_pairs) && ((pair = pair_at(i)) != 0)) {
+          writer.put_bits(pair, 2);
+          ++i;
+        }
+
+        // the last packet of a plane has no terminator
+        if (i < num_pairs) {
+          writer.put_bits(0b00, 2);
+        }
+      } else {
+        std::size_t n = 0;
+        while ((i < num_pairs) && (pair_at(i) == 0)) {
+          ++n;
+          ++i;
+        }
+
+        put_run(writer, n);
+      }
+
+      packet_is_data = !packet_is_data;
+    }
+  }
+}
+
+gbemu::SpriteImage gbemu::image_from_tiles(
+  std::span<const std::uint8_t> tiles, std::uint8_t width,
+  std::uint8_t height
+) {
+  SpriteImage image;
+  image.width = width;
+  image.height = height;
+
+  std::size_t size = std::min<std::size_t>(tiles.size() / 2, PLANE_SIZE);
+  for (std::size_t i = 0; i < size; ++i) {
+    image.low[i] = tiles[i * 2];
+    image.high[i] = tiles[(i * 2) + 1];
+  }
+
+  return image;
+}
+
+gbemu::Encoder::Encoder(unsigned int jobs) : jobs(std::max(1u, jobs)) {}
+
+gbemu::EncodedSprite gbemu::Encoder::encode(const SpriteImage &image) const {
+  // mode major, so the first of several equally short candidates is the
+  // lowest mode without a swap
+  constexpr std::size_t candidate_count = 6;
+  std::array<EncodedSprite, candidate_count> candidates;
+
+  std::atomic<std::size_t> next = 0;
+  std::exception_ptr error;
+  std::atomic<bool> failed = false;
+
+  auto worker = [&]() {
+    while (!failed) {
+      std::size_t i = next++;
+      if (i >= candidate_count) {
+        break;
+      }
+
+      try {
+        candidates[i] = encode(image, (i / 2) + 1, (i % 2) == 1);
+      } catch (...) {
+        if (!failed.exchange(true)) {
+          error = std::current_exception();
+        }
+      }
+    }
+  };
+
+  std::size_t thread_count = std::min<std::size_t>(jobs, candidate_count);
+  std::vector<std::thread> threads;
+  for (std::size_t i = 1; i < thread_count; ++i) {
+    threads.emplace_back(worker);
+  }
+  worker();
+
+  for (auto &t : threads) {
+    t.join();
+  }
+
+  if (error) {
+    std::rethrow_exception(error);
+  }
+
+  std::size_t best = 0;
+  for (std::size_t i = 1; i < candidate_count; ++i) {
+    if (candidates[i].bit_count < candidates[best].bit_count) {
+      best = i;
+    }
+  }
+
+  return std::move(candidates[best]);
+}
+
+gbemu::EncodedSprite gbemu::Encoder::encode(
+  const SpriteImage &image, std::uint8_t encoding_mode, bool swap_buffers
+) const {
+  if ((encoding_mode < 1) || (encoding_mode > 3)) {
+    std::stringstream ss;
+    ss << "encoding mode " << int(encoding_mode) << " out of range.";
+    throw std::out_of_range(ss.str());
+  }
+
+  // the header has room for 15x15, the decoder's planes do not
+  if (
+    (image.width == 0) || (image.width > MAX_SPRITE_TILES) ||
+    (image.height == 0) || (image.height > MAX_SPRITE_TILES)
+  ) {
+    std::stringstream ss;
+    ss << "sprite size " << int(image.width) << "x" << int(image.height);
+    ss << " out of range.";
+    throw std::out_of_range(ss.str());
+  }
+
+  std::size_t num_rows = image.height * 8;
+  std::size_t num_cols = image.width;
+
+  Plane primary = swap_buffers ? image.high : image.low;
+  Plane secondary = swap_buffers ? image.low : image.high;
+
+  // modes 2 and 3 store secondary ^ primary, mode 2 without delta coding
+  if (encoding_mode != 1) {
+    for (std::size_t i = 0; i < secondary.size(); ++i) {
+      secondary[i] ^= primary[i];
+    }
+  }
+
+  delta_encode(primary, num_rows, num_cols);
+  if (encoding_mode != 2) {
+    delta_encode(secondary, num_rows, num_cols);
+  }
+
+  BitWriter writer;
+  writer.put_bits(image.width, 4);
+  writer.put_bits(image.height, 4);
+  writer.put_bits(swap_buffers, 1);
+
+  rle_encode(writer, primary, num_rows, num_cols);
+
+  // mode 1 is a single 0, modes 2 and 3 are 10 and 11
+  if (encoding_mode == 1) {
+    writer.put_bits(0b0, 1);
+  } else {
+    writer.put_bits(encoding_mode == 2 ? 0b10 : 0b11, 2);
+  }
+
+  rle_encode(writer, secondary, num_rows, num_cols);
+
+  EncodedSprite encoded;
+  encoded.encoding_mode = encoding_mode;
+  encoded.swap_buffers = swap_buffers;
+  encoded.bit_count = writer.bit_count;
+  encoded.data = writer.finish();
+
+  return encoded;
+}
@@ -0,0 +1,58 @@
+#ifndef __GBEMU_SPRITE_ENCODER_HPP__
+#define __GBEMU_SPRITE_ENCODER_HPP__
+
+#include <array>
+#include <span>
+#include <vector>
+
+#include <cstdint>
+
+#include "planes.hpp"
+
+namespace gbemu {
+  // A 2bpp sprite as two bitplanes in the decoder's layout: column-major,
+  // height * 8 bytes per 8 pixel wide column, low bits in `low`.
+  struct SpriteImage {
+    std::uint8_t width = 0;
+    std::uint8_t height = 0;
+    std::array<std::uint8_t, PLANE_SIZE> low {};
+    std::array<std::uint8_t, PLANE_SIZE> high {};
+  };
+
+  // split zipped tile data (see Decoder::finalise()) back into planes
+  SpriteImage image_from_tiles(
+    std::span<const std::uint8_t> tiles, std::uint8_t width,
+    std::uint8_t height
+  );
+
+  struct EncodedSprite {
+    std::uint8_t encoding_mode = 1;
+    bool swap_buffers = false;
+    std::vector<std::uint8_t> data;
+    std::size_t bit_count = 0;
+  };
+
+  // Compresses sprites into the format Decoder reads (docs/rle.md,
+  // docs/delta.md).
+  //
+  // encode() tries every encoding mode with and without swapped planes and
+  // keeps the shortest bitstream, ties go to the lowest mode without a swap.
+  // With jobs > 1 the candidates are encoded on that many threads.
+  class Encoder {
+  public:
+    explicit Encoder(unsigned int jobs=1);
+
+    EncodedSprite encode(const SpriteImage &image) const;
+
+    // a single candidate, throws std::out_of_range for an invalid mode or a
+    // sprite larger than 7x7 tiles
+    EncodedSprite encode(
+      const SpriteImage &image, std::uint8_t encoding_mode, bool swap_buffers
+    ) const;
+
+  private:
+    unsigned int jobs;
+  };
+}
+
+#endif // __GBEMU_SPRITE_ENCODER_HPP__
@@ -1,12 +1,14 @@
 #include <exception>
+#include <stdexcept>
 #include <bitset>
 #include <algorithm>
 #include "../util/image.hpp"
+#include "rasteriser.hpp"
 
 #include "spriterenderer.hpp"
 
 gbemu::Renderer::Renderer(
-  const std::vector<std::uint8_t> &data, std::uint8_t width,
+  std::span<const std::uint8_t> data, std::uint8_t width,
   std::uint8_t height
 ) : data(data), width(width), height(height) {
   colour_palette = {
@@ -20,9 +22,33 @@ gbemu::Renderer::Renderer(
 void gbemu::Renderer::set_palette(
   const std::vector<std::array<std::uint8_t, 3>> &palette
 ) {
+  if (palette.size() < 4) {
+    throw std::invalid_argument(
+      "palette has " + std::to_string(palette.size()) + " colours, needs 4"
+    );
+  }
+
   colour_palette = palette;
 }
 
+void gbemu::Renderer::render(std::span<std::uint8_t, RASTER_SIZE> raster) {
+  rasterise(data, width, height, raster);
+
+  width = RASTER_WIDTH / 8;
+  height = RASTER_HEIGHT / 8;
+  data = raster;
+}
+
+void gbemu::Renderer::render_doubled(
+  std::span<std::uint8_t, RASTER_SIZE> raster
+) {
+  rasterise_doubled(data, width, height, raster);
+
+  width = RASTER_WIDTH / 8;
+  height = RASTER_HEIGHT / 8;
+  data = raster;
+}
+
 void gbemu::Renderer::interlace() {
   // each two bytes are the low and high bits for 4 pixels
 
@@ -33,7 +59,7 @@ void gbemu::Renderer::interlace() {
     std::uint8_t a = data[i];
     std::uint8_t b = data[i + 1];
 
-    std::uint16_t s;
+    std::uint16_t s = 0;
     for (std::size_t i = 0; i <= 7; ++i) {
       s <<= 1;
       s |= (b & (0b10000000 >> i)) >> (7 - i);
@@ -49,7 +75,8 @@ void gbemu::Renderer::interlace() {
     zipped_data.push_back(d);
   }
 
-  data = zipped_data;
+  staged = std::move(zipped_data);
+  data = staged;
 }
 
 void gbemu::Renderer::expand() {
@@ -65,7 +92,8 @@ void gbemu::Renderer::expand() {
     }
   }
 
-  data = expanded_data;
+  staged = std::move(expanded_data);
+  data = staged;
 }
 
 void gbemu::Renderer::add_padding() {
@@ -114,7 +142,8 @@ void gbemu::Renderer::add_padding() {
 
   width = 7;
   height = 7;
-  data = padded_data;
+  staged = std::move(padded_data);
+  data = staged;
 }
 
 void gbemu::Renderer::transpose() {
@@ -154,41 +183,100 @@ void gbemu::Renderer::transpose() {
     }
   }
 
-  data = transposed_data;
+  staged = std::move(transposed_data);
+  data = staged;
 }
 
 void gbemu::Renderer::save(
   const std::filesystem::path &directory, const std::string &name,
   IMAGE_FORMAT format, bool create_dirs
 ) {
-  std::stringstream ss;
+  std::filesystem::path filepath = directory / filename(name, format);
   std::vector<std::uint8_t> output_data;
-  std::filesystem::path filepath;
 
   switch (format) {
     case IMAGE_FORMAT::PGM:
+      pixels(format, output_data);
+      save_pgm(output_data, width * 8, height * 8, filepath, create_dirs);
+      break;
+
+    case IMAGE_FORMAT::PPM:
+      pixels(format, output_data);
+      save_ppm(output_data, width * 8, height * 8, filepath, create_dirs);
+      break;
+
+    case IMAGE_FORMAT::PNG:
+      // palette indices as they are, the palette goes into the file
+      save_png(
+        data, width * 8, height * 8, colour_palette, filepath, create_dirs
+      );
+      break;
+  }
+}
+
+std::vector<std::uint8_t> gbemu::Renderer::encode(IMAGE_FORMAT format) const {
+  std::string header;
+
+  switch (format) {
+    case IMAGE_FORMAT::PGM:
+      header = pgm_header(width * 8, height * 8);
+      break;
+
+    case IMAGE_FORMAT::PPM:
+      header = ppm_header(width * 8, height * 8);
+      break;
+
+    case IMAGE_FORMAT::PNG:
+      return encode_png(data, width * 8, height * 8, colour_palette);
+  }
+
+  // the pixels go straight in behind the header
+  std::vector<std::uint8_t> output_data(header.begin(), header.end());
+  pixels(format, output_data);
+
+  return output_data;
+}
+
+std::string gbemu::Renderer::filename(
+  const std::string &name, IMAGE_FORMAT format
+) {
+  switch (format) {
+    case IMAGE_FORMAT::PGM:
+      return name + ".pgm";
+
+    case IMAGE_FORMAT::PPM:
+      return name + ".ppm";
+
+    case IMAGE_FORMAT::PNG:
+      return name + ".png";
+  }
+
+  return name;
+}
+
+void gbemu::Renderer::pixels(
+  IMAGE_FORMAT format, std::vector<std::uint8_t> &output_data
+) const {
+  switch (format) {
+    case IMAGE_FORMAT::PGM:
+      output_data.reserve(output_data.size() + data.size());
       for (unsigned char b : data) {
         output_data.push_back(0b00000011 - b);
       }
-
-      ss << name << ".pgm";
-      filepath = directory / ss.str();
-      save_pgm(output_data, width * 8, height * 8, filepath, create_dirs);
-
       break;
 
     case IMAGE_FORMAT::PPM:
+      output_data.reserve(output_data.size() + (data.size() * 3));
       for (auto b : data) {
         auto c = colour_palette[b];
         for (std::size_t i = 0; i < 3; ++i) {
           output_data.push_back(c[i]);
         }
       }
+      break;
 
-      ss << name << ".ppm";
-      filepath = directory / ss.str();
-      save_ppm(output_data, width * 8, height * 8, filepath, create_dirs);
-
+    case IMAGE_FORMAT::PNG:
+      output_data.insert(output_data.end(), data.begin(), data.end());
       break;
   }
 }
@@ -3,28 +3,44 @@
 
 #include <array>
 #include <filesystem>
+#include <span>
 #include <string>
 #include <vector>
 
 #include <cstdint>
 
+#include "rasteriser.hpp"
+
 namespace gbemu {
   enum class IMAGE_FORMAT {
     PGM,
-    PPM
+    PPM,
+    PNG
   };
 
+  // Renders and encodes a sprite. The tile data is read where it is, not
+  // copied, so it has to outlive the Renderer, and so does the raster given
+  // to render() or render_doubled().
   class Renderer {
   public:
     Renderer(
-      const std::vector<std::uint8_t> &data, std::uint8_t width,
+      std::span<const std::uint8_t> data, std::uint8_t width,
       std::uint8_t height
     );
+    Renderer(const Renderer &) = delete;
+    Renderer &operator=(const Renderer &) = delete;
 
+    // one colour for each of the 4 pixel values, extra colours are unused.
+    // Throws std::invalid_argument for fewer than 4.
     void set_palette(
       const std::vector<std::array<std::uint8_t, 3>> &palette
     );
 
+    // all four stages below in a single pass into raster, see rasterise()
+    void render(std::span<std::uint8_t, RASTER_SIZE> raster);
+    // back sprites, twice the size in the same box, see rasterise_doubled()
+    void render_doubled(std::span<std::uint8_t, RASTER_SIZE> raster);
+
     void interlace();
     void expand();
     void add_padding();
@@ -34,8 +50,22 @@ namespace gbemu {
       const std::filesystem::path &directory, const std::string &name,
       IMAGE_FORMAT format, bool create_dirs
     );
+
+    // the contents save() would write, for writing them somewhere else
+    std::vector<std::uint8_t> encode(IMAGE_FORMAT format) const;
+    static std::string filename(const std::string &name, IMAGE_FORMAT format);
   private:
-    std::vector<std::uint8_t> data;
+    // appends the output pixels for a format, grey levels, rgb or palette
+    // indices
+    void pixels(
+      IMAGE_FORMAT format, std::vector<std::uint8_t> &output_data
+    ) const;
+
+
+    // the current pixels or tiles, in staged or somewhere the caller owns
+    std::span<const std::uint8_t> data;
+    // output of the stages above, which render() does not need
+    std::vector<std::uint8_t> staged;
     std::uint8_t width;
     std::uint8_t height;
     std::vector<std::array<std::uint8_t, 3>> colour_palette;
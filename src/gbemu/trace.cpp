@@ -0,0 +1,44 @@
+#include <array>
+
+#include "trace.hpp"
+
+namespace {
+  constexpr std::uint16_t TRACE_VERSION = 1;
+}
+
+gbemu::Trace::Trace(const std::filesystem::path &path)
+  : file(path, std::ios::out | std::ios::binary | std::ios::trunc) {
+  if (!file) {
+    return;
+  }
+
+  std::array<char, 8> header = {
+    'P', 'K', 'T', 'R', TRACE_VERSION & 0xff, TRACE_VERSION >> 8, 0, 0
+  };
+  file.write(header.data(), header.size());
+}
+
+bool gbemu::Trace::is_open() const {
+  return file.is_open() && file.good();
+}
+
+void gbemu::Trace::record(
+  std::uint8_t id, std::uint8_t bank, std::uint16_t offset,
+  std::uint8_t width, std::uint8_t height, std::uint8_t mode,
+  TRACE_STAGE stage, std::span<const std::uint8_t> first,
+  std::span<const std::uint8_t> second
+) {
+  std::uint32_t length = first.size() + second.size();
+
+  std::array<char, 12> header = {
+    char(id), char(bank), char(offset & 0xff), char(offset >> 8),
+    char(width), char(height), char(mode), char(stage),
+    char(length & 0xff), char((length >> 8) & 0xff),
+    char((length >> 16) & 0xff), char(length >> 24)
+  };
+
+  std::lock_guard<std::mutex> lock(mutex);
+  file.write(header.data(), header.size());
+  file.write(reinterpret_cast<const char*>(first.data()), first.size());
+  file.write(reinterpret_cast<const char*>(second.data()), second.size());
+}
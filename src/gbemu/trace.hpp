@@ -0,0 +1,54 @@
+#ifndef __GBEMU_TRACE_HPP__
+#define __GBEMU_TRACE_HPP__
+
+#include <filesystem>
+#include <fstream>
+#include <mutex>
+#include <span>
+
+#include <cstdint>
+
+namespace gbemu {
+  // Stage capture is only compiled in with -DGBEMU_TRACE (make TRACE=1),
+  // callers test this with `if constexpr` so release builds do no debug work
+#ifdef GBEMU_TRACE
+  constexpr bool TRACE_ENABLED = true;
+#else
+  constexpr bool TRACE_ENABLED = false;
+#endif
+
+  enum class TRACE_STAGE : std::uint8_t {
+    RLE = 0,    // both planes after rle decoding
+    DELTA = 1,  // both planes after delta decoding
+    FINAL = 2   // zipped tile data
+  };
+
+  // One binary file per run holding a snapshot of every decoder stage.
+  //
+  // file header: "PKTR", version (u16 LE), reserved (u16)
+  // record:      id, bank, offset (u16 LE), width, height, mode, stage,
+  //              length (u32 LE), then `length` bytes
+  // Plane snapshots hold width * height * 8 bytes of plane 1 followed by the
+  // same of plane 2, in decoder (column-major) order.
+  //
+  // record() is safe to call from several threads.
+  class Trace {
+  public:
+    explicit Trace(const std::filesystem::path &path);
+
+    bool is_open() const;
+
+    void record(
+      std::uint8_t id, std::uint8_t bank, std::uint16_t offset,
+      std::uint8_t width, std::uint8_t height, std::uint8_t mode,
+      TRACE_STAGE stage, std::span<const std::uint8_t> first,
+      std::span<const std::uint8_t> second={}
+    );
+
+  private:
+    std::mutex mutex;
+    std::ofstream file;
+  };
+}
+
+#endif // __GBEMU_TRACE_HPP__
@@ -0,0 +1,111 @@
+#include <algorithm>
+#include <array>
+#include <span>
+
+#include "../gbemu/planes.hpp"
+#include "../gbemu/rasteriser.hpp"
+#include "../gbemu/spritedecoder.hpp"
+
+#include "pkmnsprite.h"
+
+static_assert(PKMNSPRITE_MAX_TILE_BYTES == gbemu::SPRITE_SIZE);
+static_assert(PKMNSPRITE_IMAGE_BYTES == gbemu::RASTER_SIZE);
+
+namespace {
+  int decode(
+    pkmnsprite_rom_view rom, std::uint8_t bank, std::uint16_t offset,
+    std::uint8_t *out_buf, std::size_t out_len, pkmnsprite_info *info
+  ) {
+    if ((rom.data == nullptr) || (out_buf == nullptr)) {
+      return PKMNSPRITE_INVALID_ARGUMENT;
+    }
+    if ((offset < 0x4000) || (offset >= 0x8000)) {
+      return PKMNSPRITE_OFFSET_OUT_OF_RANGE;
+    }
+
+    // everything lives on the stack, the decoder's planes included
+    gbemu::Decoder decoder(std::span<const std::uint8_t>(rom.data, rom.size));
+    if (!decoder.set_bank(bank)) {
+      return PKMNSPRITE_BANK_OUT_OF_RANGE;
+    }
+
+    decoder.clear(0);
+    decoder.clear(1);
+    decoder.clear(2);
+    decoder.set_offset(offset);
+    if (!decoder.read_header()) {
+      return PKMNSPRITE_INVALID_SPRITE;
+    }
+
+    std::size_t size = decoder.width * decoder.height * 16;
+    if (info != nullptr) {
+      info->width = decoder.width;
+      info->height = decoder.height;
+      info->encoding_mode = 0;
+      info->swap_buffers = decoder.swap_buffers;
+      info->size = size;
+    }
+    if (out_len < size) {
+      return PKMNSPRITE_BUFFER_TOO_SMALL;
+    }
+
+    decoder.rle_decode(decoder.primary_buffer);
+    decoder.read_encoding_mode();
+    decoder.rle_decode(decoder.secondary_buffer);
+    if (decoder.rom_interface.exhausted()) {
+      return PKMNSPRITE_TRUNCATED;
+    }
+
+    decoder.delta_decode(decoder.primary_buffer);
+    if (decoder.encoding_mode != 2) {
+      decoder.delta_decode(decoder.secondary_buffer);
+    }
+
+    std::array<std::uint8_t, gbemu::SPRITE_SIZE> tiles;
+    decoder.finalise(tiles);
+    std::copy(tiles.begin(), tiles.begin() + size, out_buf);
+
+    if (info != nullptr) {
+      info->encoding_mode = decoder.encoding_mode;
+    }
+
+    return PKMNSPRITE_OK;
+  }
+}
+
+int pkmnsprite_decode_sprite(
+  pkmnsprite_rom_view rom, uint8_t bank, uint16_t offset, uint8_t *out_buf,
+  size_t out_len, pkmnsprite_info *info
+) {
+  // nothing in the decode path throws, but no exception may reach a C caller
+  try {
+    return decode(rom, bank, offset, out_buf, out_len, info);
+  } catch (...) {
+    return PKMNSPRITE_INTERNAL_ERROR;
+  }
+}
+
+int pkmnsprite_rasterise(
+  const uint8_t *tiles, size_t tiles_len, uint8_t width, uint8_t height,
+  int doubled, uint8_t *out_buf, size_t out_len
+) {
+  if ((tiles == nullptr) || (out_buf == nullptr)) {
+    return PKMNSPRITE_INVALID_ARGUMENT;
+  }
+  if (out_len < PKMNSPRITE_IMAGE_BYTES) {
+    return PKMNSPRITE_BUFFER_TOO_SMALL;
+  }
+
+  std::span<const std::uint8_t> input(tiles, tiles_len);
+  std::span<std::uint8_t, gbemu::RASTER_SIZE> output(
+    out_buf, gbemu::RASTER_SIZE
+  );
+
+  if (doubled) {
+    gbemu::rasterise_doubled(input, width, height, output);
+  } else {
+    gbemu::rasterise(input, width, height, output);
+  }
+
+  return PKMNSPRITE_OK;
+}
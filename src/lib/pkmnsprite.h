@@ -0,0 +1,84 @@
+#ifndef __PKMNSPRITE_H__
+#define __PKMNSPRITE_H__
+
+/*
+ * libpkmnsprite, the sprite decoder as a C library.
+ *
+ * Every function works only on the buffers it is given: nothing is
+ * allocated, nothing is read from or written to files and there is no state
+ * kept between calls, so any number of threads can decode from the same rom
+ * at once. Build with `make lib` (out/lib/libpkmnsprite.a and .so).
+ */
+
+#include <stddef.h>
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#if defined(PKMNSPRITE_BUILD)
+#define PKMNSPRITE_API __attribute__((visibility("default")))
+#else
+#define PKMNSPRITE_API
+#endif
+
+/* largest sprite, 7x7 tiles of 16 bytes */
+#define PKMNSPRITE_MAX_TILE_BYTES 784
+/* sprites are drawn into a 56x56 pixel box, one byte per pixel */
+#define PKMNSPRITE_IMAGE_WIDTH 56
+#define PKMNSPRITE_IMAGE_HEIGHT 56
+#define PKMNSPRITE_IMAGE_BYTES (PKMNSPRITE_IMAGE_WIDTH * PKMNSPRITE_IMAGE_HEIGHT)
+
+enum pkmnsprite_status {
+  PKMNSPRITE_OK = 0,
+  PKMNSPRITE_INVALID_ARGUMENT = 1,   /* null pointer */
+  PKMNSPRITE_BANK_OUT_OF_RANGE = 2,  /* the bank is not in the rom */
+  PKMNSPRITE_OFFSET_OUT_OF_RANGE = 3,/* offset outside 0x4000 - 0x7fff */
+  PKMNSPRITE_INVALID_SPRITE = 4,     /* width or height not 1 to 7 tiles */
+  PKMNSPRITE_TRUNCATED = 5,          /* sprite data runs past the bank */
+  PKMNSPRITE_BUFFER_TOO_SMALL = 6,   /* see the required size in info */
+  PKMNSPRITE_INTERNAL_ERROR = 7
+};
+
+/* the whole rom image, as loaded from disk */
+struct pkmnsprite_rom_view {
+  const uint8_t *data;
+  size_t size;
+};
+
+struct pkmnsprite_info {
+  uint8_t width;          /* in tiles */
+  uint8_t height;         /* in tiles */
+  uint8_t encoding_mode;  /* 1 to 3 */
+  uint8_t swap_buffers;
+  size_t size;            /* tile bytes, width * height * 16 */
+};
+
+/*
+ * Decodes the sprite at bank:offset (offset is a bank 1 address, as stored
+ * in the base stats) into 2bpp tile data, 16 bytes per tile, tiles in
+ * column order. out_len must be at least info.size, PKMNSPRITE_MAX_TILE_BYTES
+ * always fits. info may be null, when it is not it is filled in whenever the
+ * header could be read, so a caller can retry with a larger buffer.
+ */
+PKMNSPRITE_API int pkmnsprite_decode_sprite(
+  struct pkmnsprite_rom_view rom, uint8_t bank, uint16_t offset,
+  uint8_t *out_buf, size_t out_len, struct pkmnsprite_info *info
+);
+
+/*
+ * Draws decoded tile data into the 56x56 box the game uses, one colour
+ * index (0 to 3) per pixel, row-major. doubled draws a back sprite at twice
+ * its size. out_len must be at least PKMNSPRITE_IMAGE_BYTES.
+ */
+PKMNSPRITE_API int pkmnsprite_rasterise(
+  const uint8_t *tiles, size_t tiles_len, uint8_t width, uint8_t height,
+  int doubled, uint8_t *out_buf, size_t out_len
+);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* __PKMNSPRITE_H__ */
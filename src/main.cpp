@@ -1,21 +1,40 @@
+#include <algorithm>
+#include <array>
+#include <atomic>
 #include <bitset>
 #include <iostream>
 #include <iomanip>
 #include <filesystem>
+#include <fstream>
+#include <memory>
 #include <sstream>
+#include <thread>
 #include <vector>
 
 #include <cstdint> // std::uint8_t
 
+#include <csignal>
+#include <unistd.h>
+
+#include "gbemu/binaryinterface.hpp"
 #include "gbemu/cartridge.hpp"
 #include "gbemu/helpers.hpp"
+#include "gbemu/jobplan.hpp"
 #include "gbemu/pokemon_red.hpp"
+#include "gbemu/romindex.hpp"
+#include "gbemu/romprofile.hpp"
+#include "gbemu/spritecache.hpp"
 #include "gbemu/spritedecoder.hpp"
 #include "gbemu/spriterenderer.hpp"
+#include "gbemu/trace.hpp"
 
+#include "util/httpserver.hpp"
 #include "util/io.hpp"
+#include "util/lrucache.hpp"
 #include "util/options.hpp"
+#include "util/report.hpp"
 #include "util/table.hpp"
+#include "util/writer.hpp"
 
 void test_ram(Cartridge &cart);
 
@@ -23,17 +42,57 @@ void test_ram(Cartridge &cart);
 // of adding new rom info.
 namespace rominfo = pkmnred;
 
+// settings shared by every sprite in a run
+struct ExtractSettings {
+  Report *report = nullptr;
+  gbemu::SpriteCache *cache = nullptr;
+  gbemu::Trace *trace = nullptr;
+  OutputWriter *writer = nullptr;
+  std::filesystem::path output_path;
+  gbemu::IMAGE_FORMAT format = gbemu::IMAGE_FORMAT::PGM;
+  bool back_sprites = false;
+  int verbose_level = 0;
+};
+
 int extract_sprite(
-  Cartridge& cart, std::uint8_t pokemon_id, int verbose_level=0
+  const Cartridge& cart, const rominfo::RomIndex& rom_index,
+  std::uint8_t pokemon_id, std::vector<std::string>& row,
+  const ExtractSettings& settings
+);
+
+int extract_all(
+  const Cartridge& cart, const rominfo::RomIndex& rom_index,
+  unsigned int jobs, const ExtractSettings& settings
+);
+
+int serve(
+  const Cartridge& cart, const rominfo::RomIndex& rom_index,
+  const std::string& address, std::size_t cache_bytes,
+  const ExtractSettings& settings
+);
+
+HttpResponse serve_request(
+  const Cartridge& cart, const rominfo::RomIndex& rom_index,
+  const std::string& path, const ExtractSettings& settings
 );
 
-void dump_plane(
-  const Cartridge& cart, const gbemu::Decoder& decoder,
-  const rominfo::PokemonStats& pokemon_stats, const std::string& name,
-  std::size_t plane
+std::string content_type(const std::string& path);
+
+// both return 1 if the sprite header is not a size the decoder can hold
+int load_sprite(
+  gbemu::Decoder& decoder, std::uint16_t offset, std::uint8_t pokemon_id,
+  gbemu::DecodedSprite& sprite, const ExtractSettings& settings
 );
 
-Tabulate tabulate;
+int decode_sprite(
+  gbemu::Decoder& decoder, std::uint16_t offset, std::uint8_t pokemon_id,
+  gbemu::DecodedSprite& sprite, gbemu::Trace *trace
+);
+
+void trace_planes(
+  gbemu::Trace& trace, const gbemu::Decoder& decoder, std::uint8_t pokemon_id,
+  gbemu::TRACE_STAGE stage
+);
 
 int main(int argc, char *argv[]) {
   OPTIONS options = parse_command_line(argc, argv);
@@ -45,64 +104,198 @@ int main(int argc, char *argv[]) {
   }
 
   Cartridge cart;
-  cart.load_rom(options.rom_path);
+  if (cart.load_rom(options.rom_path)) {
+    std::cerr << "Unable to load ROM " << options.rom_path << std::endl;
+    return 1;
+  }
+
+  rominfo::ProfileRegistry profiles;
+  if (!options.profiles_path.empty()) {
+    try {
+      profiles.load(options.profiles_path);
+    } catch (std::exception& e) {
+      std::cerr << e.what() << std::endl;
+      return 1;
+    }
+  }
 
   // Check rom loaded successfully
-  std::vector<std::uint8_t> name = cart.read(0x134, 16);
+  const rominfo::RomProfile *profile = profiles.detect(cart);
+
+  if (profile == nullptr) {
+    std::cerr << "File appears to be incorrect, no profile for title \"";
+    std::cerr << rominfo::header_title(cart) << "\" checksum ";
+    std::cerr << gbhelp::hex_str(rominfo::header_checksum(cart), 2);
+    std::cerr << "\nPlease supply path to one of:" << std::endl;
+    for (const rominfo::RomProfile& known : profiles.profiles()) {
+      std::cerr << "  " << known.name << std::endl;
+    }
+    return 1;
+  }
+
+  // status goes to stderr, stdout may be carrying the report
+  std::cerr << "Successfully loaded " << profile->name << std::endl;
 
-  if (name != rominfo::name) {
-    std::cerr << "File appears to be incorrect\nPlease supply path to ";
-    std::cerr << rominfo::name_string << " ROM" << std::endl;
+  // all metadata is read once up front, workers only read from the index
+  rominfo::RomIndex rom_index;
+  try {
+    rom_index.build(cart, *profile);
+  } catch (std::out_of_range& e) {
+    std::cerr << e.what() << std::endl;
     return 1;
   }
 
-  std::cout << "Successfully loaded " << rominfo::name_string << std::endl;
-  std::cout << "------------------------------------------------" << std::endl;
-
-  tabulate.set_column_config(0, {12, 0, true,  false}); // PKMN NAME
-  tabulate.set_column_config(1, { 4, 0, false, false}); // ID
-  tabulate.set_column_config(2, { 5, 0, false, false}); // DEXNO
-  tabulate.set_column_config(3, { 4, 2, false, true }); // BANK
-  tabulate.set_column_config(4, { 6, 4, true,  true }); // ADDR
-  tabulate.set_column_config(5, { 4, 0, false, false}); // MODE
-  tabulate.set_column_config(6, { 5, 0, true,  false}); // SWAP?
-  tabulate.add_header({
-    "PKMN_NAME",
-    "ID",
-    "DEXNO",
-    "BANK",
-    "ADDR",
-    "MODE",
-    "SWAP?"
-  });
-  tabulate.add_hr();
+  const gbhelp::DecodeReport& text_report = rom_index.text_report();
+  if (text_report.unknown_total != 0) {
+    std::cerr << text_report.unknown_total << " unknown characters in text";
+    for (std::size_t c = 0; c < text_report.unknown.size(); ++c) {
+      if (text_report.unknown[c] != 0) {
+        std::cerr << " " << gbhelp::hex_str(c, 1);
+      }
+    }
+    std::cerr << std::endl;
+  }
+  std::cerr << "------------------------------------------------" << std::endl;
+
+  // rows are written as sprites finish, to stdout unless a file is given
+  REPORT_FORMAT report_format;
+  if (options.report_format == "table") {
+    report_format = REPORT_FORMAT::TABLE;
+  } else if (options.report_format == "ndjson") {
+    report_format = REPORT_FORMAT::NDJSON;
+  } else if (options.report_format == "csv") {
+    report_format = REPORT_FORMAT::CSV;
+  } else {
+    std::cerr << "Unknown report format " << options.report_format;
+    std::cerr << std::endl;
+    return 1;
+  }
 
-  if (options.extract_all) {
-    for (std::uint8_t i = 1; i <= 151; ++i) {
-      // cart.ram.fill(0);
+  std::ofstream report_file;
+  if (!options.report_path.empty()) {
+    report_file.open(options.report_path);
+    if (!report_file.is_open()) {
+      std::cerr << "Unable to open report file " << options.report_path;
+      std::cerr << std::endl;
+      return 1;
+    }
+  }
 
-      std::uint8_t index = rominfo::dex_to_index[i - 1];
-      std::uint8_t err = extract_sprite(cart, index, options.verbose_level);
-      if (err) {
-        return err;
+  Report report(
+    options.report_path.empty() ? std::cout : report_file, report_format, {
+      {"PKMN_NAME", "name",  {12, 0, true,  false}, VALUE_TYPE::STRING},
+      {"ID",        "id",    { 4, 0, false, false}, VALUE_TYPE::NUMBER},
+      {"DEXNO",     "dexno", { 5, 0, false, false}, VALUE_TYPE::NUMBER},
+      {"BANK",      "bank",  { 4, 2, false, true }, VALUE_TYPE::STRING},
+      {"ADDR",      "addr",  { 6, 4, true,  true }, VALUE_TYPE::STRING},
+      {"MODE",      "mode",  { 4, 0, false, false}, VALUE_TYPE::NUMBER},
+      {"SWAP?",     "swap",  { 5, 0, true,  false}, VALUE_TYPE::BOOL}
+    }
+  );
+
+  // decoded sprites are keyed on the rom contents, so a cache directory can
+  // be shared between different dumps
+  std::unique_ptr<gbemu::SpriteCache> cache;
+  if (!options.cache_path.empty()) {
+    cache = std::make_unique<gbemu::SpriteCache>(
+      options.cache_path, cart.fingerprint()
+    );
+
+    std::size_t count = cache->load();
+    if (options.verbose_level >= 1) {
+      std::cerr << "Loaded " << count << " cached sprites" << std::endl;
+    }
+  }
+
+  // stage snapshots for the whole run go into a single file
+  std::unique_ptr<gbemu::Trace> trace;
+  if constexpr (gbemu::TRACE_ENABLED) {
+    if (!options.trace_path.empty()) {
+      trace = std::make_unique<gbemu::Trace>(options.trace_path);
+      if (!trace->is_open()) {
+        std::cerr << "Unable to open trace file " << options.trace_path;
+        std::cerr << std::endl;
+        return 1;
       }
+    }
+  }
 
+  // images are handed to the writer, decoding never waits for the disk.
+  // --serve answers from memory and writes nothing.
+  std::unique_ptr<OutputWriter> writer;
+  if (options.serve_address.empty()) {
+    writer = std::make_unique<OutputWriter>();
+    if (options.verbose_level >= 1) {
+      std::cerr << "Writing images with ";
+      std::cerr << (writer->uses_io_uring() ? "io_uring" : "a thread pool");
+      std::cerr << std::endl;
+    }
+  }
+
+  ExtractSettings settings;
+  settings.report = &report;
+  settings.cache = cache.get();
+  settings.trace = trace.get();
+  settings.writer = writer.get();
+  settings.output_path = options.output_path;
+  settings.back_sprites = options.back_sprites;
+  settings.verbose_level = options.verbose_level;
+
+  if (options.format == "pgm") {
+    settings.format = gbemu::IMAGE_FORMAT::PGM;
+  } else if (options.format == "ppm") {
+    settings.format = gbemu::IMAGE_FORMAT::PPM;
+  } else if (options.format == "png") {
+    settings.format = gbemu::IMAGE_FORMAT::PNG;
+  } else {
+    std::cerr << "Unknown image format " << options.format << std::endl;
+    return 1;
+  }
+
+  if (options.serve_address.empty()) {
+    report.write_header();
+  }
+
+  if (!options.serve_address.empty()) {
+    int err = serve(
+      cart, rom_index, options.serve_address,
+      options.serve_cache_mb * 1024 * 1024, settings
+    );
+    if (err) {
+      return err;
+    }
+  } else if (options.extract_all) {
+    int err = extract_all(cart, rom_index, options.jobs, settings);
+    if (err) {
+      return err;
     }
   } else {
     std::uint8_t index = options.index;
 
     if (options.dexno != 0) {
-      index = rominfo::dex_to_index[(options.dexno - 1)];
+      index = rom_index.id_from_dex(options.dexno);
     }
 
-    std::uint8_t err = extract_sprite(cart, index, options.verbose_level);
+    std::vector<std::string> row;
+    std::uint8_t err = extract_sprite(cart, rom_index, index, row, settings);
 
     if (err) {
       return err;
     }
+
+    report.submit(0, std::move(row));
   }
 
-  std::cout << tabulate << std::endl;
+  std::size_t failed_writes = writer ? writer->flush() : 0;
+  if (failed_writes != 0) {
+    std::cerr << "Unable to write " << failed_writes << " images" << std::endl;
+    return 1;
+  }
+
+  if (cache && cache->save()) {
+    std::cerr << "Unable to save sprite cache to " << options.cache_path;
+    std::cerr << std::endl;
+  }
 
   return 0;
 }
@@ -121,127 +314,476 @@ void test_ram(Cartridge &cart) {
     }
   }
 
-  gbhelp::dump_ram(cart, "debug", "ram", true);
+  gbhelp::dump_ram(
+    std::span<const std::uint8_t>(cart.ram).first(1176), "debug", "ram", true
+  );
+}
+
+int extract_all(
+  const Cartridge& cart, const rominfo::RomIndex& rom_index,
+  unsigned int jobs, const ExtractSettings& settings
+) {
+  // workers share the cartridge, each sprite gets a decoder of its own
+  // (scratch included) that only reads the rom. Sprites are decoded bank by
+  // bank inside runs of plan_window pokedex rows (see plan_jobs()), rows
+  // keep their pokedex number so the report still comes out in pokedex
+  // order. The report streams a run at a time and holds at most a run's
+  // rows, a plan over the whole pokedex would hold every row until the
+  // last bank was done.
+  constexpr std::size_t plan_window = 32;
+  std::size_t count = rom_index.dex_count();
+  std::vector<int> errors(count, 0);
+
+  std::vector<std::uint8_t> ids(count);
+  for (std::size_t i = 0; i < count; ++i) {
+    ids[i] = rom_index.id_from_dex(i + 1);
+  }
+  std::vector<rominfo::SpriteJob> plan = rominfo::plan_jobs(
+    rom_index, ids, plan_window
+  );
+
+  std::atomic<std::size_t> next = 0;
+  std::atomic<bool> failed = false;
+
+  auto worker = [&]() {
+    while (!failed) {
+      std::size_t j = next++;
+      if (j >= plan.size()) {
+        break;
+      }
+
+      std::size_t i = plan[j].row;
+      std::vector<std::string> row;
+      errors[i] = extract_sprite(
+        cart, rom_index, plan[j].pokemon_id, row, settings
+      );
+      if (errors[i]) {
+        failed = true;
+      } else {
+        settings.report->submit(i, std::move(row));
+      }
+    }
+  };
+
+  if (jobs == 0) {
+    jobs = std::max(1u, std::thread::hardware_concurrency());
+  }
+  jobs = std::min<std::size_t>(jobs, count);
+
+  std::vector<std::thread> threads;
+  for (unsigned int i = 1; i < jobs; ++i) {
+    threads.emplace_back(worker);
+  }
+  worker();
+
+  for (auto& t : threads) {
+    t.join();
+  }
+
+  for (std::size_t i = 0; i < count; ++i) {
+    if (errors[i]) {
+      return errors[i];
+    }
+  }
+
+  return 0;
 }
 
 int extract_sprite(
-  Cartridge& cart, std::uint8_t pokemon_id, int verbose_level
+  const Cartridge& cart, const rominfo::RomIndex& rom_index,
+  std::uint8_t pokemon_id, std::vector<std::string>& row,
+  const ExtractSettings& settings
 ) {
   /////////////////////////////////////////////////////////////////////////////
   // Fetch pokemon information
   rominfo::PokemonStats pokemon_stats;
   try {
-    pokemon_stats = rominfo::get_stats(pokemon_id, cart);
+    pokemon_stats = rom_index.stats(pokemon_id);
   } catch (std::out_of_range& e) {
-    std::cout << e.what() << std::endl;
+    std::cerr << e.what() << std::endl;
     return 1;
   }
 
-  if (verbose_level >= 1) {
-    std::cout << "Information for " << pokemon_stats.name << ", ";
-    std::cout << " ID (" << int(pokemon_stats.id) << ")";
-    std::cout << " DexNo (" << int(pokemon_stats.dexno) << ")\n";
-    std::cout << "Sprite data location\n";
-    std::cout << "  BANK  " << gbhelp::hex_str(rominfo::sprite_banks[(pokemon_stats.id - 1)], 1) << '\n';
-    std::cout << "  Front " << gbhelp::hex_str(pokemon_stats.front_sprite_offset, 2) << '\n';
-    std::cout << "  Back  " << gbhelp::hex_str(pokemon_stats.back_sprite_offset, 2) << '\n';
-    std::cout << "------------------------------------------------" << std::endl;
+  std::uint8_t bank = rom_index.sprite_bank(pokemon_stats.id);
+
+  if (settings.verbose_level >= 1) {
+    std::cerr << "Information for " << pokemon_stats.name << ", ";
+    std::cerr << " ID (" << int(pokemon_stats.id) << ")";
+    std::cerr << " DexNo (" << int(pokemon_stats.dexno) << ")\n";
+    std::cerr << "Sprite data location\n";
+    std::cerr << "  BANK  " << gbhelp::hex_str(bank, 1) << '\n';
+    std::cerr << "  Front " << gbhelp::hex_str(pokemon_stats.front_sprite_offset, 2) << '\n';
+    std::cerr << "  Back  " << gbhelp::hex_str(pokemon_stats.back_sprite_offset, 2) << '\n';
+    std::cerr << "------------------------------------------------" << std::endl;
   }
   /////////////////////////////////////////////////////////////////////////////
-  // Fetch and decode sprite data
-  gbemu::Decoder decoder(cart, verbose_level);
-  decoder.clear(0);
-  decoder.clear(1);
-  decoder.clear(2);
-  decoder.set_bank(rominfo::sprite_banks[pokemon_stats.id - 1]);
-  decoder.set_offset(pokemon_stats.front_sprite_offset);
-  decoder.read_header();
-  decoder.rle_decode(decoder.primary_buffer);
-  decoder.read_encoding_mode();
-  decoder.rle_decode(decoder.secondary_buffer);
-  gbhelp::dump_ram(cart, "debug", "rle", true);
-
-  dump_plane(cart, decoder, pokemon_stats, "rle", 1);
-  dump_plane(cart, decoder, pokemon_stats, "rle", 2);
-
-  decoder.delta_decode(decoder.primary_buffer);
-  if (decoder.encoding_mode != 2) {
-    decoder.delta_decode(decoder.secondary_buffer);
+  // Fetch and decode sprite data, front and back sprites are in the same
+  // bank so one decoder does both
+  gbemu::Decoder decoder(cart.rom_data(), settings.verbose_level);
+  if (!decoder.set_bank(bank)) {
+    std::cerr << "sprite bank " << gbhelp::hex_str(bank, 1);
+    std::cerr << " is not in the rom" << std::endl;
+    return 1;
   }
-  gbhelp::dump_ram(cart, "debug", "delta", true);
 
-  dump_plane(cart, decoder, pokemon_stats, "delta", 1);
-  dump_plane(cart, decoder, pokemon_stats, "delta", 2);
-
-  if (decoder.encoding_mode != 1) {
-    decoder.xor_planes();
+  gbemu::DecodedSprite sprite;
+  if (load_sprite(
+    decoder, pokemon_stats.front_sprite_offset, pokemon_stats.id, sprite,
+    settings
+  )) {
+    std::cerr << "invalid sprite header for " << pokemon_stats.name;
+    std::cerr << " @ " << gbhelp::hex_str(bank, 1) << ":";
+    std::cerr << gbhelp::hex_str(pokemon_stats.front_sprite_offset, 2, false);
+    std::cerr << std::endl;
+    return 1;
   }
-  gbhelp::dump_ram(cart, "debug", "xor", true);
-
-  decoder.clear(0);
-  decoder.copy(1, 0);
-  decoder.clear(1);
-  decoder.copy(2, 1);
-  decoder.zip_planes();
-  gbhelp::dump_ram(cart, "debug", "final", true);
 
-  tabulate.add_row({
+  row = {
     pokemon_stats.name,
     Tabulate::int_str(pokemon_stats.id),
     Tabulate::int_str(pokemon_stats.dexno),
-    Tabulate::hex_str(rominfo::sprite_banks[(pokemon_stats.id - 1)], 1),
+    Tabulate::hex_str(bank, 1),
     Tabulate::hex_str(pokemon_stats.front_sprite_offset, 2),
-    Tabulate::int_str(decoder.encoding_mode),
-    Tabulate::bool_str(decoder.swap_buffers)
-  });
+    Tabulate::int_str(sprite.encoding_mode),
+    Tabulate::bool_str(sprite.swap_buffers)
+  };
 
   /////////////////////////////////////////////////////////////////////////////
   // Convert tile data and export image
-  std::vector<std::uint8_t> sprite_data;
-  std::copy(
-    &cart.ram[392],
-    &cart.ram[1176],
-    std::back_inserter(sprite_data)
-  );
-
-  gbemu::Renderer renderer(sprite_data, decoder.width, decoder.height);
-  renderer.interlace();
-  renderer.expand();
-  renderer.add_padding();
-  renderer.transpose();
+  std::array<std::uint8_t, gbemu::RASTER_SIZE> raster;
+  gbemu::Renderer renderer(sprite.tiles, sprite.width, sprite.height);
+  renderer.render(raster);
 
   std::stringstream ss;
   ss << std::setw(3) << std::setfill('0') << int(pokemon_stats.dexno) << ".";
   ss << pokemon_stats.name;
-  renderer.save("output", ss.str(), gbemu::IMAGE_FORMAT::PGM, true);
+  std::string filename = gbemu::Renderer::filename(ss.str(), settings.format);
+  settings.writer->write(
+    settings.output_path / filename, renderer.encode(settings.format)
+  );
+
+  // back sprites are drawn at twice their size, like the game does
+  if (settings.back_sprites) {
+    gbemu::DecodedSprite back_sprite;
+    if (load_sprite(
+      decoder, pokemon_stats.back_sprite_offset, pokemon_stats.id,
+      back_sprite, settings
+    )) {
+      std::cerr << "invalid sprite header for " << pokemon_stats.name;
+      std::cerr << " @ " << gbhelp::hex_str(bank, 1) << ":";
+      std::cerr << gbhelp::hex_str(pokemon_stats.back_sprite_offset, 2, false);
+      std::cerr << std::endl;
+      return 1;
+    }
+
+    // the front sprite is written, its raster can be drawn over
+    gbemu::Renderer back_renderer(
+      back_sprite.tiles, back_sprite.width, back_sprite.height
+    );
+    back_renderer.render_doubled(raster);
+
+    settings.writer->write(
+      settings.output_path / "back" / filename,
+      back_renderer.encode(settings.format)
+    );
+  }
 
   return 0;
 }
 
-void dump_plane(
-  const Cartridge& cart, const gbemu::Decoder& decoder,
-  const rominfo::PokemonStats& pokemon_stats, const std::string& name,
-  std::size_t plane
+namespace {
+  // written to by the signal handler, serve() waits on the other end
+  int stop_pipe[2] = {-1, -1};
+
+  void request_stop(int) {
+    char c = 0;
+    [[maybe_unused]] ssize_t n = write(stop_pipe[1], &c, 1);
+  }
+}
+
+int serve(
+  const Cartridge& cart, const rominfo::RomIndex& rom_index,
+  const std::string& address, std::size_t cache_bytes,
+  const ExtractSettings& settings
 ) {
-  /////////////////////////////////////////////////////////////////////////////
-  // Convert tile data and export image
-  std::vector<std::uint8_t> sprite_data;
+  // the rom and index stay loaded, encoded responses are kept by path
+  LruCache responses(cache_bytes);
+  HttpServer *self = nullptr;
+
+  HttpServer server([&](const HttpRequest& request) {
+    std::string path = request.target.substr(0, request.target.find('?'));
+
+    if (path == "/metrics") {
+      LatencySummary latency = self->latency().summary();
+
+      std::stringstream ss;
+      ss << "{\"requests\":" << latency.count;
+      ss << ",\"p50_us\":" << (latency.p50 / 1e3);
+      ss << ",\"p99_us\":" << (latency.p99 / 1e3);
+      ss << ",\"max_us\":" << (latency.max / 1e3);
+      ss << ",\"cache\":{\"entries\":" << responses.size();
+      ss << ",\"bytes\":" << responses.bytes();
+      ss << ",\"hits\":" << responses.hits();
+      ss << ",\"misses\":" << responses.misses() << "}}";
+
+      HttpResponse response = HttpResponse::text(200, ss.str());
+      response.content_type = "application/json";
+      return response;
+    }
+
+    HttpResponse response;
+    response.content_type = content_type(path);
+    response.body = responses.find(path);
+    if (response.body) {
+      return response;
+    }
+
+    response = serve_request(cart, rom_index, path, settings);
+    if (response.status == 200) {
+      responses.insert(path, response.body);
+    }
 
-  std::size_t offset = plane * 392;
+    return response;
+  });
+  self = &server;
 
-  for (std::size_t i = 0; i < 392; ++i) {
-    sprite_data.push_back(cart.ram[offset + i]);
-    sprite_data.push_back(cart.ram[offset + i]);
+  if (server.listen(address)) {
+    return 1;
   }
 
-  gbemu::Renderer renderer(sprite_data, decoder.width, decoder.height);
-  renderer.interlace();
-  renderer.expand();
-  renderer.add_padding();
-  renderer.transpose();
+  if (pipe(stop_pipe) != 0) {
+    std::cerr << "Unable to create stop pipe" << std::endl;
+    return 1;
+  }
 
-  std::stringstream ss;
-  ss << std::setw(3) << std::setfill('0') << int(pokemon_stats.dexno) << ".";
-  ss << pokemon_stats.name << "_" << name << "_plane_" << plane;
-  renderer.save("debug", ss.str(), gbemu::IMAGE_FORMAT::PGM, true);
+  struct sigaction action {};
+  action.sa_handler = request_stop;
+  sigemptyset(&action.sa_mask);
+  sigaction(SIGINT, &action, nullptr);
+  sigaction(SIGTERM, &action, nullptr);
+
+  server.start();
+  std::cout << "Serving on " << address << std::endl;
+
+  char c;
+  while ((read(stop_pipe[0], &c, 1) < 0) && (errno == EINTR)) {}
+
+  server.stop();
+  close(stop_pipe[0]);
+  close(stop_pipe[1]);
+
+  LatencySummary latency = server.latency().summary();
+  std::cout << "Served " << latency.count << " requests, p50 ";
+  std::cout << (latency.p50 / 1e3) << "us, p99 " << (latency.p99 / 1e3);
+  std::cout << "us, " << responses.hits() << " cache hits" << std::endl;
+
+  return 0;
+}
+
+HttpResponse serve_request(
+  const Cartridge& cart, const rominfo::RomIndex& rom_index,
+  const std::string& path, const ExtractSettings& settings
+) {
+  // /front/<dexno>.<format>, /back/<dexno>.<format> or /stats/<dexno>, the
+  // format is pgm, ppm, png or 2bpp (the decoded tiles as they are in vram)
+  std::size_t slash = path.find('/', 1);
+  if (slash == std::string::npos) {
+    return HttpResponse::text(404, "not found");
+  }
+
+  std::string kind = path.substr(1, slash - 1);
+  std::string file = path.substr(slash + 1);
+  std::size_t dot = file.find('.');
+  std::string number = file.substr(0, dot);
+  std::string extension;
+  if (dot != std::string::npos) {
+    extension = file.substr(dot + 1);
+  }
+
+  if (
+    number.empty() || (number.size() > 3) ||
+    (number.find_first_not_of("0123456789") != std::string::npos)
+  ) {
+    return HttpResponse::text(404, "not a pokedex number: " + number);
+  }
+
+  std::size_t dexno = std::stoul(number);
+  std::uint8_t pokemon_id = 0;
+  if ((dexno != 0) && (dexno <= rom_index.dex_count())) {
+    pokemon_id = rom_index.id_from_dex(dexno);
+  }
+  if (!rom_index.contains(pokemon_id)) {
+    return HttpResponse::text(404, "no pokemon with pokedex number " + number);
+  }
+
+  if ((kind == "stats") && extension.empty()) {
+    std::stringstream ss;
+    ss << rom_index.stats(pokemon_id);
+    return HttpResponse::text(200, ss.str());
+  }
+
+  if ((kind != "front") && (kind != "back")) {
+    return HttpResponse::text(404, "not found");
+  }
+
+  gbemu::IMAGE_FORMAT format = gbemu::IMAGE_FORMAT::PGM;
+  if (extension == "ppm") {
+    format = gbemu::IMAGE_FORMAT::PPM;
+  } else if (extension == "png") {
+    format = gbemu::IMAGE_FORMAT::PNG;
+  } else if ((extension != "pgm") && (extension != "2bpp")) {
+    return HttpResponse::text(404, "unknown format " + extension);
+  }
+
+  // requests run side by side, each decoder has its own bank and scratch
+  gbemu::Decoder decoder(cart.rom_data());
+  if (!decoder.set_bank(rom_index.sprite_bank(pokemon_id))) {
+    return HttpResponse::text(500, "sprite bank is not in the rom");
+  }
+
+  std::uint16_t offset = (kind == "front")
+    ? rom_index.front_sprite_offset(pokemon_id)
+    : rom_index.back_sprite_offset(pokemon_id);
+
+  // the rom is at fault, not the request
+  gbemu::DecodedSprite sprite;
+  if (load_sprite(decoder, offset, pokemon_id, sprite, settings)) {
+    return HttpResponse::text(500, "invalid sprite header");
+  }
+
+  HttpResponse response;
+  response.content_type = content_type(path);
+
+  if (extension == "2bpp") {
+    std::size_t size = std::min<std::size_t>(
+      sprite.width * sprite.height * 16, sprite.tiles.size()
+    );
+    response.body = std::make_shared<std::vector<std::uint8_t>>(
+      sprite.tiles.begin(), sprite.tiles.begin() + size
+    );
+    return response;
+  }
+
+  std::array<std::uint8_t, gbemu::RASTER_SIZE> raster;
+  gbemu::Renderer renderer(sprite.tiles, sprite.width, sprite.height);
+  if (kind == "front") {
+    renderer.render(raster);
+  } else {
+    renderer.render_doubled(raster);
+  }
+
+  response.body = std::make_shared<std::vector<std::uint8_t>>(
+    renderer.encode(format)
+  );
+  return response;
+}
+
+std::string content_type(const std::string& path) {
+  if (path.ends_with(".png")) {
+    return "image/png";
+  } else if (path.ends_with(".pgm")) {
+    return "image/x-portable-graymap";
+  } else if (path.ends_with(".ppm")) {
+    return "image/x-portable-pixmap";
+  } else if (path.ends_with(".2bpp")) {
+    return "application/octet-stream";
+  }
+
+  return "text/plain";
+}
+
+int load_sprite(
+  gbemu::Decoder& decoder, std::uint16_t offset, std::uint8_t pokemon_id,
+  gbemu::DecodedSprite& sprite, const ExtractSettings& settings
+) {
+  gbemu::SpriteCache *cache = settings.cache;
+  if (cache && cache->find(decoder.bank, offset, sprite)) {
+    return 0;
+  }
+
+  if (decode_sprite(decoder, offset, pokemon_id, sprite, settings.trace)) {
+    return 1;
+  }
+
+  if (cache) {
+    cache->insert(decoder.bank, offset, sprite);
+  }
+
+  return 0;
+}
+
+int decode_sprite(
+  gbemu::Decoder& decoder, std::uint16_t offset, std::uint8_t pokemon_id,
+  gbemu::DecodedSprite& sprite, gbemu::Trace *trace
+) {
+  decoder.clear(0);
+  decoder.clear(1);
+  decoder.clear(2);
+  decoder.set_offset(offset);
+  if (!decoder.read_header()) {
+    return 1;
+  }
+  decoder.rle_decode(decoder.primary_buffer);
+  decoder.read_encoding_mode();
+  decoder.rle_decode(decoder.secondary_buffer);
+
+  if constexpr (gbemu::TRACE_ENABLED) {
+    if (trace) {
+      trace_planes(*trace, decoder, pokemon_id, gbemu::TRACE_STAGE::RLE);
+    }
+  }
+
+  decoder.delta_decode(decoder.primary_buffer);
+  if (decoder.encoding_mode != 2) {
+    decoder.delta_decode(decoder.secondary_buffer);
+  }
+
+  if constexpr (gbemu::TRACE_ENABLED) {
+    if (trace) {
+      trace_planes(
+        *trace, decoder, pokemon_id, gbemu::TRACE_STAGE::DELTA
+      );
+    }
+  }
+
+  // xor (modes 2 and 3) and zip the planes
+  decoder.finalise(sprite.tiles);
+
+  sprite.width = decoder.width;
+  sprite.height = decoder.height;
+  sprite.encoding_mode = decoder.encoding_mode;
+  sprite.swap_buffers = decoder.swap_buffers;
+
+  if constexpr (gbemu::TRACE_ENABLED) {
+    if (trace) {
+      std::size_t size = std::min<std::size_t>(
+        sprite.width * sprite.height * 16, sprite.tiles.size()
+      );
+
+      trace->record(
+        pokemon_id, decoder.bank, decoder.offset, sprite.width,
+        sprite.height, sprite.encoding_mode, gbemu::TRACE_STAGE::FINAL,
+        std::span<const std::uint8_t>(sprite.tiles).first(size)
+      );
+    }
+  }
+
+  return 0;
+}
+
+void trace_planes(
+  gbemu::Trace& trace, const gbemu::Decoder& decoder, std::uint8_t pokemon_id,
+  gbemu::TRACE_STAGE stage
+) {
+  // only the part of each plane the sprite covers
+  std::size_t size = std::min<std::size_t>(
+    decoder.width * decoder.height * 8, gbemu::PLANE_SIZE
+  );
+
+  trace.record(
+    pokemon_id, decoder.bank, decoder.offset, decoder.width, decoder.height,
+    decoder.encoding_mode, stage,
+    std::span<const std::uint8_t>(decoder.scratch.plane(1), size),
+    std::span<const std::uint8_t>(decoder.scratch.plane(2), size)
+  );
 }
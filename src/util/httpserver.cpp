@@ -0,0 +1,436 @@
+#include <algorithm>
+#include <chrono>
+#include <iostream>
+#include <string_view>
+
+#include <cerrno>
+#include <cstring>
+
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <sys/socket.h>
+#include <sys/uio.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+#include "httpserver.hpp"
+
+namespace {
+  constexpr std::size_t max_header_bytes = 8192;
+  constexpr int listen_backlog = 64;
+  constexpr time_t idle_seconds = 60;
+
+  std::string lowercase(std::string_view s) {
+    std::string result(s);
+    for (char &c : result) {
+      if ((c >= 'A') && (c <= 'Z')) {
+        c += 'a' - 'A';
+      }
+    }
+
+    return result;
+  }
+
+  std::string_view trim(std::string_view s) {
+    std::size_t start = s.find_first_not_of(" \t");
+    if (start == std::string_view::npos) {
+      return {};
+    }
+
+    return s.substr(start, s.find_last_not_of(" \t") + 1 - start);
+  }
+
+  // the request line and headers, without the blank line that ends them
+  bool parse_request(
+    std::string_view head, HttpRequest &request, std::size_t &body_length
+  ) {
+    std::size_t eol = head.find("\r\n");
+    std::string_view line = head.substr(0, eol);
+    head = (eol == std::string_view::npos) ? "" : head.substr(eol + 2);
+
+    std::size_t first = line.find(' ');
+    std::size_t second = line.find(' ', first + 1);
+    if (
+      (first == std::string_view::npos) ||
+      (second == std::string_view::npos)
+    ) {
+      return false;
+    }
+
+    std::string_view version = line.substr(second + 1);
+    request.method = line.substr(0, first);
+    request.target = line.substr(first + 1, second - first - 1);
+    if (
+      (request.target.empty()) || (request.target[0] != '/') ||
+      !version.starts_with("HTTP/1.")
+    ) {
+      return false;
+    }
+
+    // 1.1 keeps the connection open unless asked not to, 1.0 the reverse
+    request.keep_alive = (version != "HTTP/1.0");
+    body_length = 0;
+
+    while (!head.empty()) {
+      eol = head.find("\r\n");
+      line = head.substr(0, eol);
+      head = (eol == std::string_view::npos) ? "" : head.substr(eol + 2);
+
+      std::size_t colon = line.find(':');
+      if (colon == std::string_view::npos) {
+        return false;
+      }
+
+      std::string name = lowercase(trim(line.substr(0, colon)));
+      std::string value = lowercase(trim(line.substr(colon + 1)));
+
+      if (name == "connection") {
+        if (value.find("close") != std::string::npos) {
+          request.keep_alive = false;
+        } else if (value.find("keep-alive") != std::string::npos) {
+          request.keep_alive = true;
+        }
+      } else if (name == "content-length") {
+        if (
+          value.empty() ||
+          (value.find_first_not_of("0123456789") != std::string::npos) ||
+          (value.size() > 9)
+        ) {
+          return false;
+        }
+        body_length = std::stoul(value);
+      } else if (name == "transfer-encoding") {
+        // a chunked body, which nothing here accepts
+        body_length = 1;
+      }
+    }
+
+    return true;
+  }
+
+  bool send_all(int fd, iovec *parts, std::size_t count) {
+    while (count != 0) {
+      msghdr message {};
+      message.msg_iov = parts;
+      message.msg_iovlen = count;
+
+      ssize_t sent = sendmsg(fd, &message, MSG_NOSIGNAL);
+      if (sent < 0) {
+        if (errno == EINTR) {
+          continue;
+        }
+        return false;
+      }
+
+      // skip what went out, part way into an iovec if needed
+      std::size_t remaining = sent;
+      while ((count != 0) && (remaining >= parts->iov_len)) {
+        remaining -= parts->iov_len;
+        ++parts;
+        --count;
+      }
+      if (count != 0) {
+        std::uint8_t *base = static_cast<std::uint8_t *>(parts->iov_base);
+        parts->iov_base = base + remaining;
+        parts->iov_len -= remaining;
+      }
+    }
+
+    return true;
+  }
+}
+
+HttpResponse HttpResponse::text(int status, const std::string &message) {
+  HttpResponse response;
+  response.status = status;
+  response.content_type = "text/plain";
+
+  auto body = std::make_shared<std::vector<std::uint8_t>>(
+    message.begin(), message.end()
+  );
+  body->push_back('\n');
+  response.body = std::move(body);
+
+  return response;
+}
+
+HttpServer::HttpServer(Handler handler) : handler(std::move(handler)) {}
+
+HttpServer::~HttpServer() {
+  stop();
+}
+
+int HttpServer::listen(const std::string &address) {
+  if (address.starts_with("unix:")) {
+    std::filesystem::path path = address.substr(5);
+
+    sockaddr_un addr {};
+    addr.sun_family = AF_UNIX;
+    if (path.empty() || (path.native().size() >= sizeof(addr.sun_path))) {
+      std::cerr << "Invalid socket path " << path << std::endl;
+      return 1;
+    }
+    std::memcpy(addr.sun_path, path.c_str(), path.native().size());
+
+    // left behind by a server that did not shut down cleanly
+    std::error_code ec;
+    if (std::filesystem::is_socket(path, ec)) {
+      std::filesystem::remove(path, ec);
+    }
+
+    listen_fd = socket(AF_UNIX, SOCK_STREAM | SOCK_CLOEXEC, 0);
+    if (
+      (listen_fd < 0) ||
+      (bind(listen_fd, reinterpret_cast<sockaddr *>(&addr), sizeof(addr)) < 0)
+    ) {
+      std::cerr << std::strerror(errno) << ", failed to bind " << path;
+      std::cerr << std::endl;
+      stop();
+      return 1;
+    }
+
+    socket_path = path;
+  } else {
+    if (
+      address.empty() || (address.size() > 5) ||
+      (address.find_first_not_of("0123456789") != std::string::npos) ||
+      (std::stoul(address) == 0) || (std::stoul(address) > 65535)
+    ) {
+      std::cerr << "Invalid port " << address << std::endl;
+      return 1;
+    }
+
+    // local tooling only, never on an outside interface
+    sockaddr_in addr {};
+    addr.sin_family = AF_INET;
+    addr.sin_port = htons(std::stoul(address));
+    addr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+
+    listen_fd = socket(AF_INET, SOCK_STREAM | SOCK_CLOEXEC, 0);
+    int reuse = 1;
+    if (
+      (listen_fd < 0) ||
+      (setsockopt(
+        listen_fd, SOL_SOCKET, SO_REUSEADDR, &reuse, sizeof(reuse)
+      ) < 0) ||
+      (bind(listen_fd, reinterpret_cast<sockaddr *>(&addr), sizeof(addr)) < 0)
+    ) {
+      std::cerr << std::strerror(errno) << ", failed to bind port ";
+      std::cerr << address << std::endl;
+      stop();
+      return 1;
+    }
+  }
+
+  if (::listen(listen_fd, listen_backlog) < 0) {
+    std::cerr << std::strerror(errno) << ", failed to listen on ";
+    std::cerr << address << std::endl;
+    stop();
+    return 1;
+  }
+
+  return 0;
+}
+
+void HttpServer::start() {
+  running = true;
+  acceptor = std::thread(&HttpServer::accept_loop, this);
+}
+
+void HttpServer::stop() {
+  running = false;
+
+  // wakes up accept() and every connection waiting on recv()
+  if (listen_fd >= 0) {
+    shutdown(listen_fd, SHUT_RDWR);
+  }
+  if (acceptor.joinable()) {
+    acceptor.join();
+  }
+
+  {
+    std::lock_guard<std::mutex> lock(mutex);
+    for (Connection &connection : connections) {
+      shutdown(connection.fd, SHUT_RDWR);
+    }
+    reap(true);
+  }
+
+  if (listen_fd >= 0) {
+    close(listen_fd);
+    listen_fd = -1;
+  }
+
+  if (!socket_path.empty()) {
+    std::error_code ec;
+    std::filesystem::remove(socket_path, ec);
+    socket_path.clear();
+  }
+}
+
+const LatencyStats &HttpServer::latency() const {
+  return latencies;
+}
+
+std::string HttpServer::status_text(int status) {
+  switch (status) {
+    case 200: return "OK";
+    case 400: return "Bad Request";
+    case 404: return "Not Found";
+    case 405: return "Method Not Allowed";
+    case 431: return "Request Header Fields Too Large";
+    case 500: return "Internal Server Error";
+    default:  return "Unknown";
+  }
+}
+
+void HttpServer::accept_loop() {
+  while (running) {
+    int fd = accept4(listen_fd, nullptr, nullptr, SOCK_CLOEXEC);
+    if (fd < 0) {
+      if (!running) {
+        break;
+      }
+      if ((errno != EINTR) && (errno != ECONNABORTED)) {
+        // most likely out of file descriptors, give connections a chance to
+        // close
+        std::cerr << std::strerror(errno) << ", accept failed" << std::endl;
+        std::this_thread::sleep_for(std::chrono::milliseconds(10));
+      }
+      continue;
+    }
+
+    // idle connections are closed, responses go out without delay
+    timeval idle {idle_seconds, 0};
+    setsockopt(fd, SOL_SOCKET, SO_RCVTIMEO, &idle, sizeof(idle));
+    if (socket_path.empty()) {
+      int nodelay = 1;
+      setsockopt(fd, IPPROTO_TCP, TCP_NODELAY, &nodelay, sizeof(nodelay));
+    }
+
+    std::lock_guard<std::mutex> lock(mutex);
+    reap(false);
+
+    Connection &connection = connections.emplace_back();
+    connection.fd = fd;
+    connection.thread = std::thread(
+      &HttpServer::serve, this, std::ref(connection)
+    );
+  }
+}
+
+void HttpServer::serve(Connection &connection) {
+  std::string buffer;
+  std::vector<char> chunk(16384);
+
+  bool open = true;
+  while (open && running) {
+    std::size_t end = buffer.find("\r\n\r\n");
+    if (std::min(end, buffer.size()) > max_header_bytes) {
+      HttpRequest request;
+      request.keep_alive = false;
+      send_response(
+        connection.fd, request, HttpResponse::text(431, "header too large")
+      );
+      break;
+    }
+
+    if (end == std::string::npos) {
+      ssize_t n = recv(connection.fd, chunk.data(), chunk.size(), 0);
+      if ((n < 0) && (errno == EINTR)) {
+        continue;
+      }
+      if (n <= 0) {
+        // closed by the client, idle for too long or stop()
+        break;
+      }
+
+      buffer.append(chunk.data(), n);
+      continue;
+    }
+
+    auto start = std::chrono::steady_clock::now();
+
+    HttpRequest request;
+    std::size_t body_length = 0;
+    bool valid = parse_request(
+      std::string_view(buffer).substr(0, end), request, body_length
+    );
+    buffer.erase(0, end + 4);
+
+    HttpResponse response;
+    if (!valid) {
+      response = HttpResponse::text(400, "bad request");
+      request.keep_alive = false;
+    } else if (body_length != 0) {
+      // the body would have to be skipped to find the next request
+      response = HttpResponse::text(400, "request bodies are not supported");
+      request.keep_alive = false;
+    } else if ((request.method != "GET") && (request.method != "HEAD")) {
+      response = HttpResponse::text(405, "only GET and HEAD are supported");
+    } else {
+      try {
+        response = handler(request);
+      } catch (std::exception &e) {
+        response = HttpResponse::text(500, e.what());
+      }
+    }
+
+    open = send_response(connection.fd, request, response);
+    open = open && request.keep_alive;
+
+    latencies.record(
+      std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::steady_clock::now() - start
+      ).count()
+    );
+  }
+
+  // the client sees the connection close now, the descriptor itself is
+  // closed by reap() so it cannot be reused while stop() might use it
+  shutdown(connection.fd, SHUT_RDWR);
+  connection.done = true;
+}
+
+bool HttpServer::send_response(
+  int fd, const HttpRequest &request, const HttpResponse &response
+) {
+  std::size_t length = response.body ? response.body->size() : 0;
+
+  std::string head = "HTTP/1.1 " + std::to_string(response.status) + " ";
+  head += status_text(response.status) + "\r\n";
+  head += "Content-Type: " + response.content_type + "\r\n";
+  head += "Content-Length: " + std::to_string(length) + "\r\n";
+  head += "Connection: ";
+  head += request.keep_alive ? "keep-alive\r\n" : "close\r\n";
+  head += "\r\n";
+
+  // header and body in one call
+  iovec parts[2] = {
+    {head.data(), head.size()},
+    {nullptr, 0}
+  };
+  std::size_t count = 1;
+  if ((length != 0) && (request.method != "HEAD")) {
+    parts[1].iov_base = const_cast<std::uint8_t *>(response.body->data());
+    parts[1].iov_len = length;
+    count = 2;
+  }
+
+  return send_all(fd, parts, count);
+}
+
+void HttpServer::reap(bool all) {
+  // called with mutex held
+  auto it = connections.begin();
+  while (it != connections.end()) {
+    if (!all && !it->done) {
+      ++it;
+      continue;
+    }
+
+    it->thread.join();
+    close(it->fd);
+    it = connections.erase(it);
+  }
+}
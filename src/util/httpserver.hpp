@@ -0,0 +1,90 @@
+#ifndef __HTTPSERVER_HPP__
+#define __HTTPSERVER_HPP__
+
+#include <atomic>
+#include <filesystem>
+#include <functional>
+#include <list>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <cstdint>
+
+#include "latency.hpp"
+
+struct HttpRequest {
+  std::string method;
+  // path and query, as sent
+  std::string target;
+  bool keep_alive = true;
+};
+
+struct HttpResponse {
+  int status = 200;
+  std::string content_type = "text/plain";
+  // shared so cached outputs are sent without a copy
+  std::shared_ptr<const std::vector<std::uint8_t>> body;
+
+  static HttpResponse text(int status, const std::string &message);
+};
+
+// Minimal HTTP/1.1 server for local tooling, on a Unix socket or a port on
+// the loopback interface.
+//
+// Every connection gets its own thread and stays open between requests
+// (keep-alive, pipelined requests are answered in order) until the client
+// closes it, asks for Connection: close or is idle for a minute. Only GET
+// and HEAD are passed to the handler. The time from a complete request to
+// the last byte of the response is recorded in latency().
+class HttpServer {
+public:
+  using Handler = std::function<HttpResponse(const HttpRequest &)>;
+
+  explicit HttpServer(Handler handler);
+  ~HttpServer();
+
+  HttpServer(const HttpServer &) = delete;
+  HttpServer &operator=(const HttpServer &) = delete;
+
+  // "unix:<path>" or a port number, returns 0 on success. A stale socket
+  // file left at the path is replaced.
+  int listen(const std::string &address);
+  // accepts connections in the background until stop()
+  void start();
+  void stop();
+
+  const LatencyStats &latency() const;
+
+  static std::string status_text(int status);
+
+private:
+  struct Connection {
+    int fd;
+    std::thread thread;
+    std::atomic<bool> done = false;
+  };
+
+  void accept_loop();
+  void serve(Connection &connection);
+  bool send_response(
+    int fd, const HttpRequest &request, const HttpResponse &response
+  );
+  // joins and closes finished connections, or all of them
+  void reap(bool all);
+
+  Handler handler;
+  LatencyStats latencies;
+
+  int listen_fd = -1;
+  std::filesystem::path socket_path;
+  std::atomic<bool> running = false;
+  std::thread acceptor;
+
+  std::mutex mutex;
+  std::list<Connection> connections;
+};
+
+#endif // __HTTPSERVER_HPP__
@@ -1,62 +1,335 @@
+#include <algorithm>
+
 #include "io.hpp"
 
 #include "image.hpp"
 
+namespace {
+  std::string pnm_header(
+    char type, std::size_t width, std::size_t height,
+    const std::string &max_value
+  ) {
+    std::string header = {'P', type, '\n'};
+    header += std::to_string(width);
+    header += ' ';
+    header += std::to_string(height);
+    header += '\n';
+    header += max_value; // max colours. 3 = 2bpp
+    header += '\n';
+
+    return header;
+  }
+
+  int save_pnm(
+    const std::string &header, std::span<const std::uint8_t> data,
+    const std::filesystem::path &filepath, bool create_dirs
+  ) {
+    std::span<const std::uint8_t> parts[] = {
+      {reinterpret_cast<const std::uint8_t *>(header.data()), header.size()},
+      data
+    };
+
+    return writeToFile(filepath, parts, create_dirs);
+  }
+}
+
+std::string pgm_header(
+  std::size_t width, std::size_t height, const std::string &max_value
+) {
+  return pnm_header('5', width, height, max_value);
+}
+
+std::string ppm_header(
+  std::size_t width, std::size_t height, const std::string &max_value
+) {
+  return pnm_header('6', width, height, max_value);
+}
+
 int save_pgm(
-  const std::vector<std::uint8_t> &data, std::size_t width, std::size_t height,
+  std::span<const std::uint8_t> data, std::size_t width, std::size_t height,
+  const std::filesystem::path &filepath, bool create_dirs,
+  const std::string &max_value
+) {
+  return save_pnm(
+    pgm_header(width, height, max_value), data, filepath, create_dirs
+  );
+}
+
+int save_ppm(
+  std::span<const std::uint8_t> data, std::size_t width, std::size_t height,
   const std::filesystem::path &filepath, bool create_dirs,
   const std::string &max_value
 ) {
-  std::vector<std::uint8_t> image_data;
+  return save_pnm(
+    ppm_header(width, height, max_value), data, filepath, create_dirs
+  );
+}
+
+namespace {
+  constexpr std::array<std::uint32_t, 256> make_crc_table() {
+    std::array<std::uint32_t, 256> table {};
+
+    for (std::uint32_t n = 0; n < 256; ++n) {
+      std::uint32_t c = n;
+      for (int k = 0; k < 8; ++k) {
+        c = (c & 1) ? (0xedb88320 ^ (c >> 1)) : (c >> 1);
+      }
+      table[n] = c;
+    }
+
+    return table;
+  }
+
+  constexpr std::array<std::uint32_t, 256> crc_table = make_crc_table();
+
+  std::uint32_t crc32(
+    const std::uint8_t *data, std::size_t size, std::uint32_t crc=0
+  ) {
+    crc = ~crc;
+    for (std::size_t i = 0; i < size; ++i) {
+      crc = crc_table[(crc ^ data[i]) & 0xff] ^ (crc >> 8);
+    }
+
+    return ~crc;
+  }
+
+  std::uint32_t adler32(const std::vector<std::uint8_t> &data) {
+    std::uint32_t a = 1;
+    std::uint32_t b = 0;
+
+    for (std::uint8_t byte : data) {
+      a = (a + byte) % 65521;
+      b = (b + a) % 65521;
+    }
+
+    return (b << 16) | a;
+  }
 
-  std::vector<std::uint8_t> header;
-  header.push_back('P');
-  header.push_back('5');
-  header.push_back('\n');
+  void put_u32(std::vector<std::uint8_t> &out, std::uint32_t v) {
+    out.push_back(v >> 24);
+    out.push_back((v >> 16) & 0xff);
+    out.push_back((v >> 8) & 0xff);
+    out.push_back(v & 0xff);
+  }
 
-  std::string w_str = std::to_string(width);
-  std::copy(w_str.begin(), w_str.end(), std::back_inserter(header));
-  header.push_back(' ');
-  std::string h_str = std::to_string(height);
-  std::copy(h_str.begin(), h_str.end(), std::back_inserter(header));
+  // deflate packs bits LSB first, Huffman codes go in MSB first
+  class DeflateWriter {
+  public:
+    explicit DeflateWriter(std::vector<std::uint8_t> &out) : out(out) {}
 
-  header.push_back('\n');
-  std::copy(max_value.begin(), max_value.end(), std::back_inserter(header));
-  // header.push_back('3'); // max colours. 3 = 2bpp
-  header.push_back('\n');
+    void put_bits(std::uint32_t value, std::size_t n) {
+      accumulator |= std::uint64_t(value) << pending;
+      pending += n;
 
-  std::copy(header.begin(), header.end(), std::back_inserter(image_data));
+      while (pending >= 8) {
+        out.push_back(accumulator & 0xff);
+        accumulator >>= 8;
+        pending -= 8;
+      }
+    }
 
-  std::copy(data.begin(), data.end(), std::back_inserter(image_data));
+    void put_code(std::uint32_t code, std::size_t n) {
+      std::uint32_t reversed = 0;
+      for (std::size_t i = 0; i < n; ++i) {
+        reversed = (reversed << 1) | ((code >> i) & 0b1);
+      }
 
-  return writeToFile(filepath, image_data, create_dirs);
+      put_bits(reversed, n);
+    }
+
+    void flush() {
+      if (pending > 0) {
+        out.push_back(accumulator & 0xff);
+        accumulator = 0;
+        pending = 0;
+      }
+    }
+
+  private:
+    std::vector<std::uint8_t> &out;
+    std::uint64_t accumulator = 0;
+    std::size_t pending = 0;
+  };
+
+  // fixed Huffman literal/length codes (RFC 1951 3.2.6)
+  void put_symbol(DeflateWriter &writer, std::uint32_t symbol) {
+    if (symbol < 144) {
+      writer.put_code(0x30 + symbol, 8);
+    } else if (symbol < 256) {
+      writer.put_code(0x190 + (symbol - 144), 9);
+    } else if (symbol < 280) {
+      writer.put_code(symbol - 256, 7);
+    } else {
+      writer.put_code(0xc0 + (symbol - 280), 8);
+    }
+  }
+
+  constexpr std::array<std::uint16_t, 29> length_base = {
+    3, 4, 5, 6, 7, 8, 9, 10, 11, 13, 15, 17, 19, 23, 27, 31, 35, 43, 51, 59,
+    67, 83, 99, 115, 131, 163, 195, 227, 258
+  };
+  constexpr std::array<std::uint8_t, 29> length_extra = {
+    0, 0, 0, 0, 0, 0, 0, 0, 1, 1, 1, 1, 2, 2, 2, 2, 3, 3, 3, 3, 4, 4, 4, 4,
+    5, 5, 5, 5, 0
+  };
+  constexpr std::array<std::uint16_t, 30> distance_base = {
+    1, 2, 3, 4, 5, 7, 9, 13, 17, 25, 33, 49, 65, 97, 129, 193, 257, 385, 513,
+    769, 1025, 1537, 2049, 3073, 4097, 6145, 8193, 12289, 16385, 24577
+  };
+  constexpr std::array<std::uint8_t, 30> distance_extra = {
+    0, 0, 0, 0, 1, 1, 2, 2, 3, 3, 4, 4, 5, 5, 6, 6, 7, 7, 8, 8, 9, 9, 10, 10,
+    11, 11, 12, 12, 13, 13
+  };
+
+  void put_match(
+    DeflateWriter &writer, std::size_t length, std::size_t distance
+  ) {
+    std::size_t l = length_base.size() - 1;
+    while (length_base[l] > length) {
+      --l;
+    }
+    put_symbol(writer, 257 + l);
+    writer.put_bits(length - length_base[l], length_extra[l]);
+
+    std::size_t d = distance_base.size() - 1;
+    while (distance_base[d] > distance) {
+      --d;
+    }
+    writer.put_code(d, 5);
+    writer.put_bits(distance - distance_base[d], distance_extra[d]);
+  }
+
+  // zlib stream holding one fixed-Huffman block. Matches come from a single
+  // entry hash table of the last position each 3 byte prefix was seen at,
+  // greedy, which is plenty for sprite sized images.
+  std::vector<std::uint8_t> deflate(const std::vector<std::uint8_t> &data) {
+    constexpr std::size_t hash_bits = 12;
+    constexpr std::size_t window = 32768;
+    constexpr std::size_t min_match = 3;
+    constexpr std::size_t max_match = 258;
+
+    std::vector<std::uint8_t> out = {0x78, 0x01};
+    DeflateWriter writer(out);
+
+    // final block, fixed Huffman codes
+    writer.put_bits(0b1, 1);
+    writer.put_bits(0b01, 2);
+
+    std::vector<std::int64_t> head(std::size_t(1) << hash_bits, -1);
+    auto hash = [&](std::size_t i) {
+      std::uint32_t v = (data[i] << 16) | (data[i + 1] << 8) | data[i + 2];
+      return (v * 2654435761u) >> (32 - hash_bits);
+    };
+
+    std::size_t i = 0;
+    while (i < data.size()) {
+      std::size_t length = 0;
+      std::size_t distance = 0;
+
+      if (i + min_match <= data.size()) {
+        std::uint32_t h = hash(i);
+        std::int64_t candidate = head[h];
+        head[h] = i;
+
+        if ((candidate >= 0) && ((i - candidate) <= window)) {
+          std::size_t limit = std::min(max_match, data.size() - i);
+          while (
+            (length < limit) && (data[candidate + length] == data[i + length])
+          ) {
+            ++length;
+          }
+          distance = i - candidate;
+        }
+      }
+
+      if (length >= min_match) {
+        put_match(writer, length, distance);
+
+        // keep the table up to date inside the match
+        for (std::size_t j = i + 1; (j < i + length); ++j) {
+          if (j + min_match <= data.size()) {
+            head[hash(j)] = j;
+          }
+        }
+        i += length;
+      } else {
+        put_symbol(writer, data[i]);
+        ++i;
+      }
+    }
+
+    put_symbol(writer, 256);
+    writer.flush();
+
+    put_u32(out, adler32(data));
+
+    return out;
+  }
+
+  void put_chunk(
+    std::vector<std::uint8_t> &out, const char *type,
+    const std::vector<std::uint8_t> &data
+  ) {
+    put_u32(out, data.size());
+
+    std::size_t start = out.size();
+    out.insert(out.end(), type, type + 4);
+    out.insert(out.end(), data.begin(), data.end());
+
+    put_u32(out, crc32(&out[start], out.size() - start));
+  }
 }
 
-int save_ppm(
-  const std::vector<std::uint8_t> &data, std::size_t width, std::size_t height,
-  const std::filesystem::path &filepath, bool create_dirs,
-  const std::string &max_value
+std::vector<std::uint8_t> encode_png(
+  std::span<const std::uint8_t> data, std::size_t width, std::size_t height,
+  const std::vector<std::array<std::uint8_t, 3>> &palette
 ) {
-  std::vector<std::uint8_t> image_data;
+  // every row is a filter type byte (0, none) and 4 pixels per byte
+  std::size_t row_size = (width + 3) / 4;
+  std::vector<std::uint8_t> rows((row_size + 1) * height, 0);
 
-  std::vector<std::uint8_t> header;
-  header.push_back('P');
-  header.push_back('6');
-  header.push_back('\n');
+  for (std::size_t y = 0; y < height; ++y) {
+    std::uint8_t *row = &rows[(y * (row_size + 1)) + 1];
 
-  std::string w_str = std::to_string(width);
-  std::copy(w_str.begin(), w_str.end(), std::back_inserter(header));
-  header.push_back(' ');
-  std::string h_str = std::to_string(height);
-  std::copy(h_str.begin(), h_str.end(), std::back_inserter(header));
+    for (std::size_t x = 0; x < width; ++x) {
+      std::size_t i = (y * width) + x;
+      std::uint8_t index = (i < data.size()) ? (data[i] & 0b11) : 0;
+      row[x / 4] |= index << ((3 - (x % 4)) * 2);
+    }
+  }
 
-  header.push_back('\n');
-  std::copy(max_value.begin(), max_value.end(), std::back_inserter(header));
-  header.push_back('\n');
+  std::vector<std::uint8_t> ihdr;
+  put_u32(ihdr, width);
+  put_u32(ihdr, height);
+  ihdr.push_back(2); // bit depth
+  ihdr.push_back(3); // indexed colour
+  ihdr.push_back(0); // deflate
+  ihdr.push_back(0); // adaptive filtering
+  ihdr.push_back(0); // no interlace
 
-  std::copy(header.begin(), header.end(), std::back_inserter(image_data));
+  // every index 0-3 needs an entry, missing ones are black
+  std::vector<std::uint8_t> plte(4 * 3, 0x00);
+  for (std::size_t i = 0; i < std::min<std::size_t>(palette.size(), 4); ++i) {
+    std::copy(palette[i].begin(), palette[i].end(), plte.begin() + (i * 3));
+  }
 
-  std::copy(data.begin(), data.end(), std::back_inserter(image_data));
+  std::vector<std::uint8_t> image_data = {
+    0x89, 'P', 'N', 'G', '\r', '\n', 0x1a, '\n'
+  };
+  put_chunk(image_data, "IHDR", ihdr);
+  put_chunk(image_data, "PLTE", plte);
+  put_chunk(image_data, "IDAT", deflate(rows));
+  put_chunk(image_data, "IEND", {});
 
-  return writeToFile(filepath, image_data, create_dirs);
+  return image_data;
+}
+
+int save_png(
+  std::span<const std::uint8_t> data, std::size_t width, std::size_t height,
+  const std::vector<std::array<std::uint8_t, 3>> &palette,
+  const std::filesystem::path &filepath, bool create_dirs
+) {
+  return writeToFile(
+    filepath, encode_png(data, width, height, palette), create_dirs
+  );
 }
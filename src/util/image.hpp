@@ -1,21 +1,48 @@
 #ifndef __IMAGE_HPP__
 #define __IMAGE_HPP__
 
+#include <array>
 #include <filesystem>
+#include <span>
+#include <string>
 #include <vector>
 
 #include <cstdint> // std::uint8_t
 
+// the netpbm header that goes in front of the pixels, "P5\n<w> <h>\n<max>\n"
+std::string pgm_header(
+  std::size_t width, std::size_t height, const std::string &max_value="3"
+);
+
+std::string ppm_header(
+  std::size_t width, std::size_t height, const std::string &max_value="255"
+);
+
+// the header and data are written with a single writev, data is not copied
 int save_pgm(
-  const std::vector<std::uint8_t> &data, std::size_t width, std::size_t height,
+  std::span<const std::uint8_t> data, std::size_t width, std::size_t height,
   const std::filesystem::path &filepath, bool create_dirs=false,
   const std::string &max_value="3"
 );
 
 int save_ppm(
-  const std::vector<std::uint8_t> &data, std::size_t width, std::size_t height,
+  std::span<const std::uint8_t> data, std::size_t width, std::size_t height,
   const std::filesystem::path &filepath, bool create_dirs=false,
   const std::string &max_value="255"
 );
 
+// data holds one palette index (0-3) per pixel, rows are packed at 2 bits
+// per pixel and compressed with a single fixed-Huffman deflate block. The
+// PLTE chunk always has 4 entries, a shorter palette is padded with black.
+std::vector<std::uint8_t> encode_png(
+  std::span<const std::uint8_t> data, std::size_t width, std::size_t height,
+  const std::vector<std::array<std::uint8_t, 3>> &palette
+);
+
+int save_png(
+  std::span<const std::uint8_t> data, std::size_t width, std::size_t height,
+  const std::vector<std::array<std::uint8_t, 3>> &palette,
+  const std::filesystem::path &filepath, bool create_dirs=false
+);
+
 #endif // __IMAGE_HPP__
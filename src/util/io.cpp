@@ -1,48 +1,101 @@
+#include <algorithm>
+#include <array>
 #include <iostream>
 #include <fstream>
 
+#include <cerrno>
+#include <cstring>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <sys/uio.h>
+#include <unistd.h>
+
 #include "io.hpp"
 
+namespace {
+  // the least IOV_MAX posix allows, more than any caller passes
+  constexpr std::size_t max_iov = 16;
+}
+
+MappedFile::MappedFile(const std::filesystem::path &path) {
+  int fd = open(path.c_str(), O_RDONLY);
+
+  if (fd != -1) {
+    struct stat st;
+    if ((fstat(fd, &st) == 0) && S_ISREG(st.st_mode) && (st.st_size > 0)) {
+      void *p = mmap(nullptr, st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+
+      if (p != MAP_FAILED) {
+        mapping = p;
+        mapping_size = st.st_size;
+        view = {static_cast<const std::uint8_t *>(p), mapping_size};
+      }
+    }
+
+    // the mapping stays valid after the descriptor is closed
+    close(fd);
+  }
+
+  if (mapping == nullptr) {
+    buffer = loadFromFile(path);
+    view = buffer;
+  }
+}
+
+MappedFile::~MappedFile() {
+  if (mapping != nullptr) {
+    munmap(mapping, mapping_size);
+  }
+}
+
+bool MappedFile::is_mapped() const {
+  return mapping != nullptr;
+}
+
+std::size_t MappedFile::size() const {
+  return view.size();
+}
+
+std::span<const std::uint8_t> MappedFile::data() const {
+  return view;
+}
+
 std::vector<std::uint8_t> loadFromFile(const std::filesystem::path& path) {
   std::ifstream ifs;
   ifs.exceptions(std::ios_base::failbit | std::ios_base::badbit);
   std::vector<std::uint8_t> data;
-  std::vector<char> buffer;
 
   try {
     ifs.open(path, std::ios::in | std::ios::binary | std::ios::ate);
     std::size_t size = ifs.tellg();
     ifs.seekg(0);
 
-    // read needs a char type
-    buffer.resize(size);
-    ifs.read(buffer.data(), size);
+    // read straight into the output, read needs a char pointer
+    data.resize(size);
+    ifs.read(reinterpret_cast<char *>(data.data()), size);
     ifs.close();
   } catch (std::ifstream::failure &e) {
     std::cerr << e.what() << ", failed to read file: " << path << std::endl;
     return {};
   }
 
-  // convert chars to std::uint8_ts
-  for (char c : buffer) {
-    data.push_back(static_cast<std::uint8_t>(c));
-  }
-
   return data;
 }
 
 int writeToFile(
-  const std::filesystem::path &path, const std::vector<std::uint8_t> &data,
+  const std::filesystem::path &path, std::span<const std::uint8_t> data,
   bool create_dirs
 ) {
-  std::ofstream ofs;
-  ofs.exceptions(std::ios_base::failbit | std::ios_base::badbit);
-  std::vector<char> buffer;
-
-  for (std::uint8_t c : data) {
-    buffer.push_back(static_cast<char>(c));
-  }
+  std::span<const std::uint8_t> parts[] = {data};
+  return writeToFile(path, parts, create_dirs);
+}
 
+int writeToFile(
+  const std::filesystem::path &path,
+  std::span<const std::span<const std::uint8_t>> parts, bool create_dirs
+) {
   if (create_dirs) {
     auto dir = path.parent_path();
     if ((dir != "") && (!std::filesystem::exists(dir))) {
@@ -50,12 +103,68 @@ int writeToFile(
     }
   }
 
-  try {
-    ofs.open(path, std::ios::out | std::ios::binary);
-    ofs.write(buffer.data(), buffer.size());
-    ofs.close();
-  } catch (std::ofstream::failure &e) {
-    std::cerr << e.what() << ", failed to write file: " << path << std::endl;
+  int fd = open(path.c_str(), O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC, 0644);
+  if (fd == -1) {
+    std::cerr << std::strerror(errno) << ", failed to write file: " << path;
+    std::cerr << std::endl;
+    return 1;
+  }
+
+  // parts are gathered a batch at a time into a fixed array, nothing is
+  // allocated per write. iov[first, count) is what is left of the batch.
+  std::array<iovec, max_iov> iov;
+  std::size_t next = 0;
+  std::size_t first = 0;
+  std::size_t count = 0;
+
+  while (true) {
+    if (first == count) {
+      first = 0;
+      count = 0;
+      for (; (next < parts.size()) && (count < iov.size()); ++next) {
+        if (!parts[next].empty()) {
+          // writev never writes through iov_base
+          iov[count++] = {
+            const_cast<std::uint8_t *>(parts[next].data()), parts[next].size()
+          };
+        }
+      }
+
+      if (count == 0) {
+        break;
+      }
+    }
+
+    ssize_t written = writev(fd, &iov[first], count - first);
+
+    if (written == -1) {
+      if (errno == EINTR) {
+        continue;
+      }
+
+      std::cerr << std::strerror(errno) << ", failed to write file: " << path;
+      std::cerr << std::endl;
+      close(fd);
+      return 1;
+    }
+
+    // a short write leaves the rest for the next call, skip what was written
+    std::size_t n = written;
+    while ((first < count) && (n >= iov[first].iov_len)) {
+      n -= iov[first].iov_len;
+      ++first;
+    }
+
+    if (n != 0) {
+      std::uint8_t *base = static_cast<std::uint8_t *>(iov[first].iov_base);
+      iov[first].iov_base = base + n;
+      iov[first].iov_len -= n;
+    }
+  }
+
+  if (close(fd) == -1) {
+    std::cerr << std::strerror(errno) << ", failed to write file: " << path;
+    std::cerr << std::endl;
     return 1;
   }
 
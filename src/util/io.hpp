@@ -2,14 +2,44 @@
 #define __IO_HPP__
 
 #include <filesystem>
+#include <span>
 #include <vector>
 
 #include <cstdint> // std::uint8_t
 
+// Read-only view of a whole file. The file is memory mapped when possible,
+// otherwise it is read into a buffer with loadFromFile().
+class MappedFile {
+public:
+  MappedFile() = default;
+  explicit MappedFile(const std::filesystem::path &path);
+  ~MappedFile();
+
+  MappedFile(const MappedFile &) = delete;
+  MappedFile &operator=(const MappedFile &) = delete;
+
+  bool is_mapped() const;
+  std::size_t size() const;
+  std::span<const std::uint8_t> data() const;
+
+private:
+  void *mapping = nullptr;
+  std::size_t mapping_size = 0;
+  std::vector<std::uint8_t> buffer;
+  std::span<const std::uint8_t> view;
+};
+
 std::vector<std::uint8_t> loadFromFile(const std::filesystem::path &path);
 int writeToFile(
-  const std::filesystem::path &path, const std::vector<std::uint8_t> &data,
+  const std::filesystem::path &path, std::span<const std::uint8_t> data,
   bool create_dirs=false
 );
 
+// writes the parts back to back with a single gathered write (writev), so
+// e.g. a header and a pixel buffer never have to be copied together first
+int writeToFile(
+  const std::filesystem::path &path,
+  std::span<const std::span<const std::uint8_t>> parts, bool create_dirs=false
+);
+
 #endif // __IO_HPP__
@@ -0,0 +1,47 @@
+#include <algorithm>
+
+#include "latency.hpp"
+
+LatencyStats::LatencyStats(std::size_t window) {
+  samples.reserve(std::max<std::size_t>(window, 1));
+}
+
+void LatencyStats::record(std::uint64_t nanoseconds) {
+  std::lock_guard<std::mutex> lock(mutex);
+
+  if (samples.size() < samples.capacity()) {
+    samples.push_back(nanoseconds);
+  } else {
+    samples[next] = nanoseconds;
+    next = (next + 1) % samples.size();
+  }
+
+  ++count;
+}
+
+LatencySummary LatencyStats::summary() const {
+  std::vector<std::uint64_t> sorted;
+  LatencySummary result;
+  {
+    std::lock_guard<std::mutex> lock(mutex);
+    sorted = samples;
+    result.count = count;
+  }
+
+  if (sorted.empty()) {
+    return result;
+  }
+
+  // nearest rank
+  auto rank = [&](std::size_t percent) {
+    std::size_t n = (sorted.size() * percent + 99) / 100;
+    return sorted[std::max<std::size_t>(n, 1) - 1];
+  };
+
+  std::sort(sorted.begin(), sorted.end());
+  result.p50 = rank(50);
+  result.p99 = rank(99);
+  result.max = sorted.back();
+
+  return result;
+}
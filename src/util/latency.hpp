@@ -0,0 +1,34 @@
+#ifndef __LATENCY_HPP__
+#define __LATENCY_HPP__
+
+#include <mutex>
+#include <vector>
+
+#include <cstdint>
+
+struct LatencySummary {
+  std::uint64_t count = 0;
+  // nanoseconds, over the most recent samples
+  std::uint64_t p50 = 0;
+  std::uint64_t p99 = 0;
+  std::uint64_t max = 0;
+};
+
+// Keeps the most recent request latencies for percentile reporting. Older
+// samples are overwritten, so the percentiles follow the current load rather
+// than everything since start up. record() is safe to call from any thread.
+class LatencyStats {
+public:
+  explicit LatencyStats(std::size_t window=65536);
+
+  void record(std::uint64_t nanoseconds);
+  LatencySummary summary() const;
+
+private:
+  mutable std::mutex mutex;
+  std::vector<std::uint64_t> samples;
+  std::size_t next = 0;
+  std::uint64_t count = 0;
+};
+
+#endif // __LATENCY_HPP__
@@ -0,0 +1,75 @@
+#include "lrucache.hpp"
+
+namespace {
+  std::size_t entry_size(const std::string &key, const LruCache::Value &value) {
+    return key.size() + (value ? value->size() : 0);
+  }
+}
+
+LruCache::LruCache(std::size_t capacity_bytes) : capacity(capacity_bytes) {}
+
+LruCache::Value LruCache::find(const std::string &key) {
+  std::lock_guard<std::mutex> lock(mutex);
+
+  auto it = index.find(key);
+  if (it == index.end()) {
+    ++miss_count;
+    return nullptr;
+  }
+
+  ++hit_count;
+  entries.splice(entries.begin(), entries, it->second);
+  return it->second->second;
+}
+
+void LruCache::insert(const std::string &key, Value value) {
+  std::size_t size = entry_size(key, value);
+  if (size > capacity) {
+    return;
+  }
+
+  std::lock_guard<std::mutex> lock(mutex);
+
+  // another thread may have put the same output in first
+  auto it = index.find(key);
+  if (it != index.end()) {
+    used -= entry_size(key, it->second->second);
+    entries.erase(it->second);
+    index.erase(it);
+  }
+
+  evict(size);
+
+  entries.emplace_front(key, std::move(value));
+  index[key] = entries.begin();
+  used += size;
+}
+
+void LruCache::evict(std::size_t needed) {
+  while (!entries.empty() && (used + needed > capacity)) {
+    Entry &oldest = entries.back();
+    used -= entry_size(oldest.first, oldest.second);
+    index.erase(oldest.first);
+    entries.pop_back();
+  }
+}
+
+std::size_t LruCache::size() const {
+  std::lock_guard<std::mutex> lock(mutex);
+  return entries.size();
+}
+
+std::size_t LruCache::bytes() const {
+  std::lock_guard<std::mutex> lock(mutex);
+  return used;
+}
+
+std::uint64_t LruCache::hits() const {
+  std::lock_guard<std::mutex> lock(mutex);
+  return hit_count;
+}
+
+std::uint64_t LruCache::misses() const {
+  std::lock_guard<std::mutex> lock(mutex);
+  return miss_count;
+}
@@ -0,0 +1,52 @@
+#ifndef __LRUCACHE_HPP__
+#define __LRUCACHE_HPP__
+
+#include <list>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#include <cstdint>
+
+// In-memory cache of encoded outputs (images, text) keyed by a string,
+// bounded by the total size of keys and values. The least recently used
+// entries are dropped first.
+//
+// Values are shared, a caller can keep using one after it has been evicted.
+// All members are safe to call from several threads.
+class LruCache {
+public:
+  using Value = std::shared_ptr<const std::vector<std::uint8_t>>;
+
+  explicit LruCache(std::size_t capacity_bytes);
+
+  // nullptr on a miss
+  Value find(const std::string &key);
+  // values that do not fit in the whole cache are not stored
+  void insert(const std::string &key, Value value);
+
+  std::size_t size() const;
+  std::size_t bytes() const;
+  std::uint64_t hits() const;
+  std::uint64_t misses() const;
+
+private:
+  using Entry = std::pair<std::string, Value>;
+
+  void evict(std::size_t needed);
+
+  std::size_t capacity;
+  std::size_t used = 0;
+  std::uint64_t hit_count = 0;
+  std::uint64_t miss_count = 0;
+
+  mutable std::mutex mutex;
+  // most recently used at the front
+  std::list<Entry> entries;
+  std::unordered_map<std::string, std::list<Entry>::iterator> index;
+};
+
+#endif // __LRUCACHE_HPP__
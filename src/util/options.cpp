@@ -11,19 +11,38 @@ OPTIONS parse_command_line(int argc, char *argv[]) {
   options.output_path = "output";
   options.index = 0;
   options.dexno = 0;
+  options.extract_all = false;
+  options.serve_cache_mb = 64;
+  options.back_sprites = false;
   options.create_dirs = false;
+  options.verbose_level = 0;
+  options.jobs = 1;
+  options.format = "pgm";
+  options.report_format = "table";
 
   app.option_defaults()->always_capture_default();
 
   app.add_option("-r,--rom", options.rom_path, "path to rom")->required();
+  app.add_option("--profiles", options.profiles_path, "file with extra rom profiles");
   app.add_option("-o,--out", options.output_path, "path to save output");
   app.add_flag("-c,--create_dirs", options.create_dirs, "create directories if needed");
+  app.add_flag("-b,--back", options.back_sprites, "also extract back sprites, into <out>/back");
   app.add_flag("-v,--verbose", options.verbose_level, "increase verbosity");
+  app.add_option("-j,--jobs", options.jobs, "worker threads for --all (0 = one per core)");
+  app.add_option("-f,--format", options.format, "image format: pgm, ppm or png");
+  app.add_option("--report", options.report_format, "report format: table, ndjson or csv");
+  app.add_option("--report_path", options.report_path, "write the report to a file instead of stdout");
+  app.add_option("--cache", options.cache_path, "directory for the decoded sprite cache");
+  app.add_option("--serve_cache", options.serve_cache_mb, "MiB of encoded responses kept in memory by --serve");
+#ifdef GBEMU_TRACE
+  app.add_option("--trace", options.trace_path, "write decoder stage snapshots to a file");
+#endif
 
   auto index = app.add_option_group("subgroup");
   index->add_option("-i,--index", options.index, "pokemon internal index");
   index->add_option("-d,--dexno", options.dexno, "pokemon pokedex number");
   index->add_flag("-a,--all", options.extract_all, "extract all sprites");
+  index->add_option("-s,--serve", options.serve_address, "serve sprites over http on a local port or unix:<path>");
   index->require_option(1);
 
   try {
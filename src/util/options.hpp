@@ -1,6 +1,7 @@
 #ifndef __OPTIONS_HPP__
 #define __OPTIONS_HPP__
 #include <filesystem>
+#include <string>
 
 #include <cstdint>
 
@@ -8,12 +9,22 @@ struct OPTIONS {
   int err;
   bool called_for_help;
   std::filesystem::path rom_path;
+  std::filesystem::path profiles_path;
   std::filesystem::path output_path;
   std::uint8_t index;
   std::uint8_t dexno;
   bool extract_all;
+  std::string serve_address;
+  std::size_t serve_cache_mb;
+  bool back_sprites;
   bool create_dirs;
   int verbose_level;
+  unsigned int jobs;
+  std::filesystem::path cache_path;
+  std::filesystem::path trace_path;
+  std::string format;
+  std::string report_format;
+  std::filesystem::path report_path;
 };
 
 OPTIONS parse_command_line(int argc, char *argv[]);
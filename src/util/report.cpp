@@ -0,0 +1,136 @@
+#include <iomanip>
+#include <sstream>
+
+#include "report.hpp"
+
+Report::Report(
+  std::ostream& os, REPORT_FORMAT format,
+  const std::vector<ReportColumn>& columns
+) : os(os), format(format), columns(columns) {
+  for (std::size_t i = 0; i < columns.size(); ++i) {
+    table.set_column_config(i, columns[i].config);
+  }
+}
+
+void Report::write_header() {
+  std::lock_guard<std::mutex> lock(mutex);
+
+  std::vector<std::string> titles;
+  for (auto& column : columns) {
+    titles.push_back(column.title);
+  }
+
+  switch (format) {
+    case REPORT_FORMAT::TABLE:
+      os << table.format_header(titles) << '\n';
+      os << table.format_hr() << '\n';
+      break;
+
+    case REPORT_FORMAT::CSV:
+      for (std::size_t i = 0; i < titles.size(); ++i) {
+        os << ((i != 0) ? "," : "") << csv_str(titles[i]);
+      }
+      os << '\n';
+      break;
+
+    case REPORT_FORMAT::NDJSON:
+      break;
+  }
+
+  os.flush();
+}
+
+void Report::submit(std::size_t index, std::vector<std::string> row) {
+  std::lock_guard<std::mutex> lock(mutex);
+
+  if (index != next) {
+    waiting[index] = std::move(row);
+    return;
+  }
+
+  write_row(row);
+  ++next;
+
+  // anything that was waiting on this row
+  auto it = waiting.begin();
+  while ((it != waiting.end()) && (it->first == next)) {
+    write_row(it->second);
+    ++next;
+    it = waiting.erase(it);
+  }
+
+  os.flush();
+}
+
+void Report::write_row(const std::vector<std::string>& row) {
+  switch (format) {
+    case REPORT_FORMAT::TABLE:
+      os << table.format_row(row) << '\n';
+      break;
+
+    case REPORT_FORMAT::CSV:
+      for (std::size_t i = 0; i < row.size(); ++i) {
+        os << ((i != 0) ? "," : "") << csv_str(row[i]);
+      }
+      os << '\n';
+      break;
+
+    case REPORT_FORMAT::NDJSON:
+      os << '{';
+      for (std::size_t i = 0; i < row.size() && i < columns.size(); ++i) {
+        os << ((i != 0) ? "," : "") << json_str(columns[i].key) << ':';
+
+        if (columns[i].type == VALUE_TYPE::STRING) {
+          os << json_str(row[i]);
+        } else {
+          os << row[i];
+        }
+      }
+      os << "}\n";
+      break;
+  }
+}
+
+std::string Report::json_str(const std::string& s) {
+  std::stringstream ss;
+  ss << '"';
+
+  for (char c : s) {
+    switch (c) {
+      case '"':  ss << "\\\""; break;
+      case '\\': ss << "\\\\"; break;
+      case '\n': ss << "\\n"; break;
+      case '\r': ss << "\\r"; break;
+      case '\t': ss << "\\t"; break;
+      default:
+        // utf-8 passes through, only control characters need escaping
+        if (static_cast<unsigned char>(c) < 0x20) {
+          ss << "\\u" << std::setw(4) << std::setfill('0') << std::hex;
+          ss << int(c) << std::dec;
+        } else {
+          ss << c;
+        }
+    }
+  }
+
+  ss << '"';
+  return ss.str();
+}
+
+std::string Report::csv_str(const std::string& s) {
+  if (s.find_first_of(",\"\r\n") == std::string::npos) {
+    return s;
+  }
+
+  // quoted, with quotes doubled
+  std::string quoted = "\"";
+  for (char c : s) {
+    if (c == '"') {
+      quoted += '"';
+    }
+    quoted += c;
+  }
+  quoted += '"';
+
+  return quoted;
+}
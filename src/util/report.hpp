@@ -0,0 +1,67 @@
+#ifndef __REPORT_HPP__
+#define __REPORT_HPP__
+
+#include <map>
+#include <mutex>
+#include <ostream>
+#include <string>
+#include <vector>
+
+#include <cstdint>
+
+#include "table.hpp"
+
+enum class REPORT_FORMAT {
+  TABLE,
+  NDJSON,
+  CSV
+};
+
+enum class VALUE_TYPE {
+  STRING,
+  NUMBER,
+  BOOL
+};
+
+struct ReportColumn {
+  std::string title;        // table and csv header
+  std::string key;          // ndjson field name
+  column_config config;     // table layout
+  VALUE_TYPE type = VALUE_TYPE::STRING; // numbers and bools are not quoted
+};
+
+// Writes result rows as soon as they are complete instead of collecting
+// them until the end of the run.
+//
+// Rows are numbered from 0 and can be submitted from any thread in any
+// order. Every row is written (and the stream flushed) once all rows before
+// it are in, so the output has the same order as a serial run and only rows
+// that arrive early are held in memory.
+class Report {
+public:
+  Report(
+    std::ostream& os, REPORT_FORMAT format,
+    const std::vector<ReportColumn>& columns
+  );
+
+  // the table header and rule, or the csv header line, ndjson has none
+  void write_header();
+  void submit(std::size_t index, std::vector<std::string> row);
+
+  static std::string json_str(const std::string& s);
+  static std::string csv_str(const std::string& s);
+
+private:
+  void write_row(const std::vector<std::string>& row);
+
+  std::ostream& os;
+  REPORT_FORMAT format;
+  std::vector<ReportColumn> columns;
+  Tabulate table;
+
+  std::mutex mutex;
+  std::map<std::size_t, std::vector<std::string>> waiting;
+  std::size_t next = 0;
+};
+
+#endif // __REPORT_HPP__
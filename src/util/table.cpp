@@ -12,6 +12,20 @@ void Tabulate::set_column_config(std::size_t col, const column_config& cfg) {
 }
 
 void Tabulate::add_header(const std::vector<std::string>& headers) {
+  table_strings.push_back(format_header(headers));
+}
+
+void Tabulate::add_hr() {
+  table_strings.push_back(format_hr());
+}
+
+void Tabulate::add_row(const std::vector<std::string>& row) {
+  table_strings.push_back(format_row(row));
+}
+
+std::string Tabulate::format_header(
+  const std::vector<std::string>& headers
+) const {
   std::stringstream ss;
   for (std::size_t i = 0; i < headers.size(); ++i) {
     auto cfg = configs[i];
@@ -22,10 +36,10 @@ void Tabulate::add_header(const std::vector<std::string>& headers) {
     }
   }
 
-  table_strings.push_back(ss.str());
+  return ss.str();
 }
 
-void Tabulate::add_hr() {
+std::string Tabulate::format_hr() const {
   std::stringstream ss;
   for (std::size_t i = 0; i < configs.size(); ++i) {
     auto cfg = configs[i];
@@ -43,10 +57,10 @@ void Tabulate::add_hr() {
     }
   }
 
-  table_strings.push_back(ss.str());
+  return ss.str();
 }
 
-void Tabulate::add_row(const std::vector<std::string>& row) {
+std::string Tabulate::format_row(const std::vector<std::string>& row) const {
   std::stringstream ss;
 
   for (std::size_t i = 0; i < row.size(); ++i) {
@@ -66,7 +80,7 @@ void Tabulate::add_row(const std::vector<std::string>& row) {
     }
   }
 
-  table_strings.push_back(ss.str());
+  return ss.str();
 }
 
 std::ostream& operator<<(std::ostream& os, const Tabulate& t) {
@@ -23,6 +23,11 @@ public:
   void add_hr();
   void add_row(const std::vector<std::string>& row);
 
+  // a single line as add_*() would store it, for printing rows one at a time
+  std::string format_header(const std::vector<std::string>& headers) const;
+  std::string format_hr() const;
+  std::string format_row(const std::vector<std::string>& row) const;
+
   friend std::ostream& operator<<(std::ostream& os, const Tabulate& t);
   static std::string hex_str(std::uint64_t i, std::size_t w);
   static std::string int_str(long long int i);
@@ -0,0 +1,476 @@
+#include <algorithm>
+#include <atomic>
+#include <iostream>
+#include <utility>
+
+#include <cerrno>
+#include <cstring>
+
+#include <fcntl.h>
+#include <linux/io_uring.h>
+#include <sys/mman.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+
+#include "io.hpp"
+
+#include "writer.hpp"
+
+namespace {
+  constexpr unsigned int RING_ENTRIES = 64;
+
+  // the ring indices are shared with the kernel
+  unsigned int load_acquire(unsigned int *p) {
+    return std::atomic_ref<unsigned int>(*p).load(std::memory_order_acquire);
+  }
+
+  void store_release(unsigned int *p, unsigned int v) {
+    std::atomic_ref<unsigned int>(*p).store(v, std::memory_order_release);
+  }
+}
+
+// A minimal io_uring instance on the raw system calls. SQEs are prepared
+// with next_sqe() and submit() hands all of them to the kernel at once and
+// waits for every completion.
+class OutputWriter::Ring {
+public:
+  Ring() = default;
+  ~Ring();
+
+  Ring(const Ring &) = delete;
+  Ring &operator=(const Ring &) = delete;
+
+  // false if the kernel has no io_uring (or it is blocked) or it cannot
+  // open, write and close files
+  bool setup(unsigned int entries);
+  unsigned int capacity() const;
+
+  io_uring_sqe *next_sqe(std::uint64_t user_data);
+
+  // results[user_data] is set to the result of every prepared SQE, returns
+  // false if the submission itself failed
+  bool submit(std::vector<int> &results);
+
+private:
+  int fd = -1;
+  unsigned int entries = 0;
+  unsigned int prepared = 0;
+
+  void *sq_ring = MAP_FAILED;
+  std::size_t sq_ring_size = 0;
+  void *cq_ring = MAP_FAILED;
+  std::size_t cq_ring_size = 0;
+  io_uring_sqe *sqes = static_cast<io_uring_sqe *>(MAP_FAILED);
+  std::size_t sqes_size = 0;
+
+  unsigned int *sq_tail = nullptr;
+  unsigned int *sq_mask = nullptr;
+  unsigned int *sq_array = nullptr;
+  unsigned int *cq_head = nullptr;
+  unsigned int *cq_tail = nullptr;
+  unsigned int *cq_mask = nullptr;
+  io_uring_cqe *cqes = nullptr;
+};
+
+OutputWriter::Ring::~Ring() {
+  if (sqes != MAP_FAILED) {
+    munmap(sqes, sqes_size);
+  }
+
+  if ((cq_ring != MAP_FAILED) && (cq_ring != sq_ring)) {
+    munmap(cq_ring, cq_ring_size);
+  }
+
+  if (sq_ring != MAP_FAILED) {
+    munmap(sq_ring, sq_ring_size);
+  }
+
+  if (fd != -1) {
+    close(fd);
+  }
+}
+
+bool OutputWriter::Ring::setup(unsigned int requested) {
+  io_uring_params params {};
+  fd = syscall(__NR_io_uring_setup, requested, &params);
+  if (fd < 0) {
+    fd = -1;
+    return false;
+  }
+
+  entries = params.sq_entries;
+  sq_ring_size = params.sq_off.array + (params.sq_entries * sizeof(unsigned));
+  cq_ring_size = params.cq_off.cqes + (
+    params.cq_entries * sizeof(io_uring_cqe)
+  );
+
+  bool single_mmap = params.features & IORING_FEAT_SINGLE_MMAP;
+  if (single_mmap) {
+    sq_ring_size = std::max(sq_ring_size, cq_ring_size);
+    cq_ring_size = sq_ring_size;
+  }
+
+  sq_ring = mmap(
+    nullptr, sq_ring_size, PROT_READ | PROT_WRITE,
+    MAP_SHARED | MAP_POPULATE, fd, IORING_OFF_SQ_RING
+  );
+  if (sq_ring == MAP_FAILED) {
+    return false;
+  }
+
+  if (single_mmap) {
+    cq_ring = sq_ring;
+  } else {
+    cq_ring = mmap(
+      nullptr, cq_ring_size, PROT_READ | PROT_WRITE,
+      MAP_SHARED | MAP_POPULATE, fd, IORING_OFF_CQ_RING
+    );
+    if (cq_ring == MAP_FAILED) {
+      return false;
+    }
+  }
+
+  sqes_size = params.sq_entries * sizeof(io_uring_sqe);
+  sqes = static_cast<io_uring_sqe *>(mmap(
+    nullptr, sqes_size, PROT_READ | PROT_WRITE,
+    MAP_SHARED | MAP_POPULATE, fd, IORING_OFF_SQES
+  ));
+  if (sqes == MAP_FAILED) {
+    return false;
+  }
+
+  char *sq = static_cast<char *>(sq_ring);
+  sq_tail = reinterpret_cast<unsigned int *>(sq + params.sq_off.tail);
+  sq_mask = reinterpret_cast<unsigned int *>(sq + params.sq_off.ring_mask);
+  sq_array = reinterpret_cast<unsigned int *>(sq + params.sq_off.array);
+
+  char *cq = static_cast<char *>(cq_ring);
+  cq_head = reinterpret_cast<unsigned int *>(cq + params.cq_off.head);
+  cq_tail = reinterpret_cast<unsigned int *>(cq + params.cq_off.tail);
+  cq_mask = reinterpret_cast<unsigned int *>(cq + params.cq_off.ring_mask);
+  cqes = reinterpret_cast<io_uring_cqe *>(cq + params.cq_off.cqes);
+
+  // openat and close only arrived in 5.6, along with the probe
+  std::size_t probe_size = sizeof(io_uring_probe) + (
+    IORING_OP_LAST * sizeof(io_uring_probe_op)
+  );
+  std::vector<std::uint8_t> probe_buffer(probe_size, 0);
+  io_uring_probe *probe = reinterpret_cast<io_uring_probe *>(
+    probe_buffer.data()
+  );
+
+  if (syscall(
+    __NR_io_uring_register, fd, IORING_REGISTER_PROBE, probe, IORING_OP_LAST
+  ) < 0) {
+    return false;
+  }
+
+  for (std::uint8_t op : {
+    IORING_OP_OPENAT, IORING_OP_WRITE, IORING_OP_CLOSE
+  }) {
+    if (
+      (op > probe->last_op) || !(probe->ops[op].flags & IO_URING_OP_SUPPORTED)
+    ) {
+      return false;
+    }
+  }
+
+  return true;
+}
+
+unsigned int OutputWriter::Ring::capacity() const {
+  return entries;
+}
+
+io_uring_sqe *OutputWriter::Ring::next_sqe(std::uint64_t user_data) {
+  // only this thread writes the tail
+  unsigned int tail = *sq_tail + prepared;
+  unsigned int index = tail & *sq_mask;
+
+  io_uring_sqe *sqe = &sqes[index];
+  std::memset(sqe, 0, sizeof(io_uring_sqe));
+  sqe->user_data = user_data;
+  sq_array[index] = index;
+
+  ++prepared;
+  return sqe;
+}
+
+bool OutputWriter::Ring::submit(std::vector<int> &results) {
+  unsigned int count = prepared;
+  prepared = 0;
+
+  if (count == 0) {
+    return true;
+  }
+
+  store_release(sq_tail, *sq_tail + count);
+
+  unsigned int to_submit = count;
+  unsigned int completed = 0;
+
+  while (completed < count) {
+    int r = syscall(
+      __NR_io_uring_enter, fd, to_submit, count - completed,
+      IORING_ENTER_GETEVENTS, nullptr, 0
+    );
+
+    if (r < 0) {
+      if (errno == EINTR) {
+        continue;
+      }
+
+      std::cerr << std::strerror(errno) << ", io_uring_enter failed";
+      std::cerr << std::endl;
+      return false;
+    }
+    to_submit -= std::min<unsigned int>(r, to_submit);
+
+    unsigned int head = *cq_head;
+    unsigned int tail = load_acquire(cq_tail);
+    while (head != tail) {
+      const io_uring_cqe &cqe = cqes[head & *cq_mask];
+      results[cqe.user_data] = cqe.res;
+
+      ++completed;
+      ++head;
+    }
+    store_release(cq_head, head);
+  }
+
+  return true;
+}
+
+OutputWriter::OutputWriter(unsigned int thread_count, bool try_io_uring) {
+  if (try_io_uring) {
+    ring = std::make_unique<Ring>();
+
+    if (ring->setup(RING_ENTRIES)) {
+      threads.emplace_back(&OutputWriter::ring_loop, this);
+      return;
+    }
+
+    ring.reset();
+  }
+
+  for (unsigned int i = 0; i < std::max(1u, thread_count); ++i) {
+    threads.emplace_back(&OutputWriter::pool_loop, this);
+  }
+}
+
+OutputWriter::~OutputWriter() {
+  {
+    std::lock_guard<std::mutex> lock(mutex);
+    stopping = true;
+  }
+  queued.notify_all();
+
+  // the loops only return once the queue is empty
+  for (auto &t : threads) {
+    t.join();
+  }
+}
+
+void OutputWriter::write(
+  std::filesystem::path path, std::vector<std::uint8_t> data
+) {
+  {
+    std::lock_guard<std::mutex> lock(mutex);
+    jobs.push_back({std::move(path), std::move(data)});
+    ++pending;
+  }
+
+  queued.notify_one();
+}
+
+std::size_t OutputWriter::flush() {
+  std::unique_lock<std::mutex> lock(mutex);
+  drained.wait(lock, [&]() { return pending == 0; });
+
+  return std::exchange(failures, 0);
+}
+
+bool OutputWriter::uses_io_uring() const {
+  return ring != nullptr;
+}
+
+bool OutputWriter::take(std::vector<Job> &batch, std::size_t max_jobs) {
+  batch.clear();
+
+  std::unique_lock<std::mutex> lock(mutex);
+  queued.wait(lock, [&]() { return stopping || !jobs.empty(); });
+
+  while (!jobs.empty() && (batch.size() < max_jobs)) {
+    batch.push_back(std::move(jobs.front()));
+    jobs.pop_front();
+  }
+
+  return !batch.empty();
+}
+
+void OutputWriter::finish(std::size_t count, std::size_t failed) {
+  std::lock_guard<std::mutex> lock(mutex);
+  pending -= count;
+  failures += failed;
+
+  if (pending == 0) {
+    drained.notify_all();
+  }
+}
+
+bool OutputWriter::create_directory(const std::filesystem::path &path) {
+  if (path.empty()) {
+    return true;
+  }
+
+  std::lock_guard<std::mutex> lock(directory_mutex);
+  if (directories.contains(path)) {
+    return true;
+  }
+
+  std::error_code ec;
+  std::filesystem::create_directories(path, ec);
+  if (ec) {
+    std::cerr << ec.message() << ", failed to create directory: " << path;
+    std::cerr << std::endl;
+    return false;
+  }
+
+  directories.insert(path);
+  return true;
+}
+
+void OutputWriter::ring_loop() {
+  std::vector<Job> batch;
+  std::vector<int> fds;
+  std::vector<int> results;
+  std::vector<std::size_t> written;
+
+  while (take(batch, ring->capacity())) {
+    std::size_t count = batch.size();
+    fds.assign(count, -1);
+    results.assign(count, 0);
+    written.assign(count, 0);
+
+    auto fail = [&](std::size_t i, int err) {
+      std::cerr << std::strerror(err) << ", failed to write file: ";
+      std::cerr << batch[i].path << std::endl;
+    };
+
+    std::vector<bool> ok(count, false);
+
+    // open the whole batch
+    for (std::size_t i = 0; i < count; ++i) {
+      if (!create_directory(batch[i].path.parent_path())) {
+        continue;
+      }
+
+      io_uring_sqe *sqe = ring->next_sqe(i);
+      sqe->opcode = IORING_OP_OPENAT;
+      sqe->fd = AT_FDCWD;
+      sqe->addr = reinterpret_cast<std::uint64_t>(batch[i].path.c_str());
+      sqe->len = 0644;
+      sqe->open_flags = O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC;
+      ok[i] = true;
+    }
+
+    if (!ring->submit(results)) {
+      ok.assign(count, false);
+    }
+
+    for (std::size_t i = 0; i < count; ++i) {
+      if (!ok[i]) {
+        continue;
+      }
+
+      if (results[i] < 0) {
+        fail(i, -results[i]);
+        ok[i] = false;
+      } else {
+        fds[i] = results[i];
+      }
+    }
+
+    // write until every file is complete, short writes go round again
+    bool more = true;
+    while (more) {
+      more = false;
+
+      for (std::size_t i = 0; i < count; ++i) {
+        if (!ok[i] || (written[i] == batch[i].data.size())) {
+          continue;
+        }
+
+        std::size_t remaining = batch[i].data.size() - written[i];
+
+        io_uring_sqe *sqe = ring->next_sqe(i);
+        sqe->opcode = IORING_OP_WRITE;
+        sqe->fd = fds[i];
+        sqe->addr = reinterpret_cast<std::uint64_t>(
+          batch[i].data.data() + written[i]
+        );
+        sqe->len = std::min<std::size_t>(remaining, 0x7ffff000);
+        sqe->off = written[i];
+        more = true;
+      }
+
+      if (!more) {
+        break;
+      }
+
+      if (!ring->submit(results)) {
+        ok.assign(count, false);
+        break;
+      }
+
+      for (std::size_t i = 0; i < count; ++i) {
+        if (!ok[i] || (written[i] == batch[i].data.size())) {
+          continue;
+        }
+
+        if (results[i] <= 0) {
+          fail(i, (results[i] < 0) ? -results[i] : EIO);
+          ok[i] = false;
+        } else {
+          written[i] += results[i];
+        }
+      }
+    }
+
+    // and close it
+    for (std::size_t i = 0; i < count; ++i) {
+      if (fds[i] != -1) {
+        io_uring_sqe *sqe = ring->next_sqe(i);
+        sqe->opcode = IORING_OP_CLOSE;
+        sqe->fd = fds[i];
+      }
+    }
+
+    if (!ring->submit(results)) {
+      ok.assign(count, false);
+    }
+
+    for (std::size_t i = 0; i < count; ++i) {
+      if ((fds[i] != -1) && ok[i] && (results[i] < 0)) {
+        fail(i, -results[i]);
+        ok[i] = false;
+      }
+    }
+
+    finish(count, std::count(ok.begin(), ok.end(), false));
+  }
+}
+
+void OutputWriter::pool_loop() {
+  std::vector<Job> batch;
+
+  while (take(batch, 1)) {
+    Job &job = batch.front();
+
+    bool ok = create_directory(job.path.parent_path()) && (
+      writeToFile(job.path, job.data) == 0
+    );
+
+    finish(1, ok ? 0 : 1);
+  }
+}
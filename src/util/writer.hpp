@@ -0,0 +1,70 @@
+#ifndef __WRITER_HPP__
+#define __WRITER_HPP__
+
+#include <condition_variable>
+#include <deque>
+#include <filesystem>
+#include <memory>
+#include <mutex>
+#include <set>
+#include <thread>
+#include <vector>
+
+#include <cstdint> // std::uint8_t
+
+// Writes whole files in the background, for bulk output.
+//
+// write() only queues the buffer, so callers never wait on the filesystem.
+// Queued files are written in batches through io_uring (open, write and
+// close for the whole batch are each a single submission) and fall back to a
+// small pool of threads doing ordinary blocking writes when io_uring is not
+// available. Every output directory is created once, the first time a file
+// is written into it.
+class OutputWriter {
+public:
+  // threads is the size of the fallback pool, try_io_uring=false always
+  // uses the pool
+  explicit OutputWriter(unsigned int threads=4, bool try_io_uring=true);
+  ~OutputWriter();
+
+  OutputWriter(const OutputWriter &) = delete;
+  OutputWriter &operator=(const OutputWriter &) = delete;
+
+  void write(std::filesystem::path path, std::vector<std::uint8_t> data);
+
+  // waits until everything queued so far is written, returns the number of
+  // files that could not be written since the last flush()
+  std::size_t flush();
+
+  bool uses_io_uring() const;
+
+private:
+  struct Job {
+    std::filesystem::path path;
+    std::vector<std::uint8_t> data;
+  };
+
+  class Ring;
+
+  void ring_loop();
+  void pool_loop();
+  bool take(std::vector<Job> &batch, std::size_t max_jobs);
+  void finish(std::size_t count, std::size_t failed);
+  bool create_directory(const std::filesystem::path &path);
+
+  std::unique_ptr<Ring> ring;
+  std::vector<std::thread> threads;
+
+  std::mutex mutex;
+  std::condition_variable queued;
+  std::condition_variable drained;
+  std::deque<Job> jobs;
+  std::size_t pending = 0;
+  std::size_t failures = 0;
+  bool stopping = false;
+
+  std::mutex directory_mutex;
+  std::set<std::filesystem::path> directories;
+};
+
+#endif // __WRITER_HPP__
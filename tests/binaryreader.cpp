@@ -1,44 +1,51 @@
+#include <algorithm>
 #include <iostream>
 #include <vector>
 
 #include <cstdint> // std::uint8_t
 
-#include "gbimg/binaryreader.hpp"
-#include "util/options.hpp"
+#include "gbemu/binaryinterface.hpp"
 
 int initialisation_data_test(
-  BinaryReader &reader, const std::vector<std::uint8_t> &expected
+  gbemu::BinaryInterface &reader, const std::vector<std::uint8_t> &expected
 );
-int initialisation_size_test(BinaryReader &reader, std::size_t expected);
-int seek_tell_test(BinaryReader &reader, std::size_t expected);
-int peek_test(BinaryReader &reader, std::size_t expected);
+int initialisation_size_test(
+  gbemu::BinaryInterface &reader, std::size_t expected
+);
+int seek_tell_test(gbemu::BinaryInterface &reader, std::size_t expected);
+int peek_test(gbemu::BinaryInterface &reader, std::size_t expected);
 int get_test(
-  BinaryReader &reader, std::size_t expected_a, std::size_t expected_b
+  gbemu::BinaryInterface &reader, std::size_t expected_a, std::size_t expected_b
+);
+int put_test(
+  gbemu::BinaryInterface &reader, std::size_t data, std::size_t expected
 );
-int put_test(BinaryReader &reader, std::size_t data, std::size_t expected);
 int extended_get_test(
-  BinaryReader &reader, std::size_t index, std::uint8_t expected
+  gbemu::BinaryInterface &reader, std::size_t index, std::uint8_t expected
 );
 
-int main(int argc, char *argv[]) {
+int main() {
   std::vector<std::uint8_t> data = {0x55, 0xaa, 0xff};
-  BinaryReader reader(data);
+  const std::vector<std::uint8_t> expected = data;
+  gbemu::BinaryInterface reader(data);
 
-  initialisation_data_test(reader, data);
-  initialisation_size_test(reader, data.size() * 8);
-  seek_tell_test(reader, 3);
-  peek_test(reader, 1);
-  get_test(reader, 1, 0);
+  int err = 0;
+  err |= initialisation_data_test(reader, expected);
+  err |= initialisation_size_test(reader, data.size() * 8);
+  err |= seek_tell_test(reader, 3);
+  err |= peek_test(reader, 1);
+  err |= get_test(reader, 1, 0);
 
-  extended_get_test(reader, 4, 0x5a);
+  err |= extended_get_test(reader, 4, 0x5a);
 
-  return 0;
+  return err;
 }
 
 int initialisation_data_test(
-  BinaryReader &reader, const std::vector<std::uint8_t> &expected
+  gbemu::BinaryInterface &reader, const std::vector<std::uint8_t> &expected
 ) {
-  if (reader.data() != expected) {
+  auto data = reader.data();
+  if (!std::equal(data.begin(), data.end(), expected.begin(), expected.end())) {
     std::cerr << "[ FAIL ] BinaryReader.data()" << std::endl;
     return 1;
   }
@@ -47,7 +54,9 @@ int initialisation_data_test(
   return 0;
 }
 
-int initialisation_size_test(BinaryReader &reader, std::size_t expected) {
+int initialisation_size_test(
+  gbemu::BinaryInterface &reader, std::size_t expected
+) {
   if (reader.size() != expected) {
     std::cerr << "[ FAIL ] BinaryReader.size()" << std::endl;
     return 1;
@@ -57,7 +66,7 @@ int initialisation_size_test(BinaryReader &reader, std::size_t expected) {
   return 0;
 }
 
-int seek_tell_test(BinaryReader &reader, std::size_t expected) {
+int seek_tell_test(gbemu::BinaryInterface &reader, std::size_t expected) {
   reader.seek(expected);
 
   std::size_t index = reader.tell();
@@ -72,7 +81,7 @@ int seek_tell_test(BinaryReader &reader, std::size_t expected) {
   return 0;
 }
 
-int peek_test(BinaryReader &reader, std::size_t expected) {
+int peek_test(gbemu::BinaryInterface &reader, std::size_t expected) {
   bool a = reader.peek();
   bool b = reader.peek();
 
@@ -91,7 +100,7 @@ int peek_test(BinaryReader &reader, std::size_t expected) {
 }
 
 int get_test(
-  BinaryReader &reader, std::size_t expected_a, std::size_t expected_b
+  gbemu::BinaryInterface &reader, std::size_t expected_a, std::size_t expected_b
 ) {
   bool a = reader.get();
   bool b = reader.get();
@@ -110,7 +119,9 @@ int get_test(
   return 0;
 }
 
-int put_test(BinaryReader &reader, std::size_t data, std::size_t expected) {
+int put_test(
+  gbemu::BinaryInterface &reader, std::size_t data, std::size_t expected
+) {
   reader.put(data);
   bool a = reader.peek();
 
@@ -125,7 +136,7 @@ int put_test(BinaryReader &reader, std::size_t data, std::size_t expected) {
 }
 
 int extended_get_test(
-  BinaryReader &reader, std::size_t index, std::uint8_t expected
+  gbemu::BinaryInterface &reader, std::size_t index, std::uint8_t expected
 ) {
   // get()
   std::uint8_t extracted_8bits = 0;
@@ -0,0 +1,120 @@
+#include <iostream>
+#include <vector>
+
+#include <cstdint> // std::uint8_t
+
+#include "gbemu/bitreader.hpp"
+
+int get_bits_test(
+  gbemu::BitReader &reader, std::size_t index, std::size_t n,
+  std::uint64_t expected
+);
+int count_ones_test(
+  gbemu::BitReader &reader, std::size_t index, std::size_t expected,
+  std::size_t expected_tell
+);
+int skip_test(
+  gbemu::BitReader &reader, std::size_t index, std::size_t n,
+  std::size_t expected
+);
+int exhausted_test(gbemu::BitReader &reader);
+
+int main() {
+  std::vector<std::uint8_t> data = {
+    0x55, 0xaa, 0xff, 0xff, 0xf0, 0x12, 0x34, 0x56,
+    0x78, 0x9a, 0xbc, 0xde, 0xf0, 0x0f
+  };
+  gbemu::BitReader reader(data.data(), data.size());
+
+  int err = 0;
+  err |= get_bits_test(reader, 0, 8, 0x55);
+  err |= get_bits_test(reader, 4, 8, 0x5a);
+  err |= get_bits_test(reader, 3, 2, 0b10);
+  err |= get_bits_test(reader, 40, 32, 0x12345678);
+  err |= get_bits_test(reader, 44, 56, 0x23456789abcdef);
+  err |= get_bits_test(reader, 100, 12, 0x00f);
+
+  err |= count_ones_test(reader, 0, 0, 1);
+  err |= count_ones_test(reader, 1, 1, 3);
+  err |= count_ones_test(reader, 16, 20, 37);
+
+  err |= skip_test(reader, 0, 40, 0x12);
+  err |= skip_test(reader, 3, 85, 0xde);
+
+  err |= exhausted_test(reader);
+
+  return err;
+}
+
+int get_bits_test(
+  gbemu::BitReader &reader, std::size_t index, std::size_t n,
+  std::uint64_t expected
+) {
+  reader.seek(index);
+  std::uint64_t bits = reader.get_bits(n);
+
+  if ((bits != expected) || (reader.tell() != (index + n))) {
+    std::cerr << "[ FAIL ] BitReader.get_bits(" << n << ") @ " << index;
+    std::cerr << ": got " << bits << ", expected " << expected << "." << std::endl;
+    return 1;
+  }
+
+  std::cout << "[ PASS ] BitReader.get_bits(" << n << ") @ " << index << std::endl;
+  return 0;
+}
+
+int count_ones_test(
+  gbemu::BitReader &reader, std::size_t index, std::size_t expected,
+  std::size_t expected_tell
+) {
+  reader.seek(index);
+  std::size_t count = reader.count_ones();
+
+  if ((count != expected) || (reader.tell() != expected_tell)) {
+    std::cerr << "[ FAIL ] BitReader.count_ones() @ " << index << ": got ";
+    std::cerr << count << ", expected " << expected << "." << std::endl;
+    return 1;
+  }
+
+  std::cout << "[ PASS ] BitReader.count_ones() @ " << index << std::endl;
+  return 0;
+}
+
+int skip_test(
+  gbemu::BitReader &reader, std::size_t index, std::size_t n,
+  std::size_t expected
+) {
+  reader.seek(index);
+  reader.get_bits(8);
+  reader.seek(index);
+  reader.skip(n);
+  std::uint8_t byte = reader.get_byte();
+
+  if (byte != expected) {
+    std::cerr << "[ FAIL ] BitReader.skip(" << n << "): got " << int(byte);
+    std::cerr << ", expected " << expected << "." << std::endl;
+    return 1;
+  }
+
+  std::cout << "[ PASS ] BitReader.skip(" << n << ")" << std::endl;
+  return 0;
+}
+
+int exhausted_test(gbemu::BitReader &reader) {
+  reader.seek(reader.size() - 4);
+  std::uint64_t bits = reader.get_bits(8);
+
+  if (!reader.exhausted() || (bits != 0xf0)) {
+    std::cerr << "[ FAIL ] BitReader.exhausted()" << std::endl;
+    return 1;
+  }
+
+  reader.seek(0);
+  if (reader.exhausted()) {
+    std::cerr << "[ FAIL ] BitReader.seek() -> exhausted()" << std::endl;
+    return 1;
+  }
+
+  std::cout << "[ PASS ] BitReader.exhausted()" << std::endl;
+  return 0;
+}
@@ -0,0 +1,149 @@
+#include <algorithm>
+#include <filesystem>
+#include <fstream>
+#include <functional>
+#include <iostream>
+#include <stdexcept>
+#include <vector>
+
+#include <cstdint> // std::uint8_t
+
+#include "gbemu/cartridge.hpp"
+#include "gbemu/helpers.hpp"
+
+std::filesystem::path write_rom();
+int read_at_test(const Cartridge &cart);
+int out_of_range_test(const Cartridge &cart);
+
+int main() {
+  int err = 0;
+
+  Cartridge cart;
+  if (cart.load_rom(write_rom())) {
+    std::cerr << "[ FAIL ] Cartridge.load_rom()" << std::endl;
+    return 1;
+  }
+
+  // the const reads must not care which bank is switched in
+  cart.switch_bank(1);
+
+  err |= read_at_test(cart);
+  err |= out_of_range_test(cart);
+
+  return err;
+}
+
+// four banks, every byte set to its bank number unless written below
+std::filesystem::path write_rom() {
+  std::vector<std::uint8_t> rom(0x4000 * 4);
+  for (std::size_t i = 0; i < rom.size(); ++i) {
+    rom[i] = i / 0x4000;
+  }
+
+  // bank 2: a pointer table at 0x4000, the strings it points to, a string
+  // that is not terminated at the end of the bank
+  std::vector<std::uint8_t> table = {0x10, 0x40, 0x14, 0x40};
+  std::vector<std::uint8_t> strings = {
+    0x81, 0x82, 0x50, 0xff, 0x83, 0x50
+  };
+  std::copy(table.begin(), table.end(), rom.begin() + 0x8000);
+  std::copy(strings.begin(), strings.end(), rom.begin() + 0x8010);
+  std::fill(rom.begin() + 0xbff0, rom.begin() + 0xc000, 0x80);
+
+  // bank 0
+  rom[0x0134] = 0x50;
+  rom[0x0135] = 0x4f;
+
+  std::filesystem::path path = std::filesystem::temp_directory_path();
+  path /= "pkmn_sprite_cartridge_test.gb";
+
+  std::ofstream ofs(path, std::ios::binary);
+  ofs.write(reinterpret_cast<const char *>(rom.data()), rom.size());
+
+  return path;
+}
+
+int read_at_test(const Cartridge &cart) {
+  std::uint16_t first = cart.read_address_from_table_at(2, 0x4000, 0);
+  std::uint16_t second = cart.read_address_from_table_at(2, 0x4000, 1);
+  std::span<const std::uint8_t> name = cart.read_string_at(2, first, 0x50);
+  std::span<const std::uint8_t> next = cart.read_string_at(2, second, 0x50);
+  std::span<const std::uint8_t> header = cart.read_at(3, 0x0134, 2);
+  std::span<const std::uint8_t> linear = cart.rom_bytes(0x8010, 3);
+
+  int err = 0;
+  if (
+    (first != 0x4010) || (second != 0x4014) ||
+    (cart.read_address_at(2, 0x4002) != 0x4014)
+  ) {
+    std::cerr << "[ FAIL ] Cartridge.read_address_from_table_at() ";
+    std::cerr << gbhelp::hex_str(first) << " " << gbhelp::hex_str(second);
+    std::cerr << std::endl;
+    err = 1;
+  }
+
+  // the terminator is part of the string
+  if (
+    (name.size() != 3) || (name[0] != 0x81) || (name[2] != 0x50) ||
+    (next.size() != 2) || (next[0] != 0x83)
+  ) {
+    std::cerr << "[ FAIL ] Cartridge.read_string_at()" << std::endl;
+    err = 1;
+  }
+
+  // bank 0 is the same whichever bank is asked for, 0x4000 is the first
+  // byte of the bank and not of bank 1
+  if (
+    (header[0] != 0x50) || (header[1] != 0x4f) ||
+    (cart.read_at(3, 0x4000) != 3) || (cart.read_at(3, 0x7fff) != 3) ||
+    (cart.read_at(1, 0x4000) != 1) ||
+    (gbhelp::absolute_address(3, 0x4000) != 0xc000)
+  ) {
+    std::cerr << "[ FAIL ] Cartridge.read_at()" << std::endl;
+    err = 1;
+  }
+
+  if (
+    (linear.size() != 3) ||
+    !std::equal(linear.begin(), linear.end(), name.begin()) ||
+    (cart.rom_string(0x8013, 0x50).size() != 3)
+  ) {
+    std::cerr << "[ FAIL ] Cartridge.rom_bytes()" << std::endl;
+    err = 1;
+  }
+
+  if (!err) {
+    std::cout << "[ PASS ] Cartridge.read_at()" << std::endl;
+  }
+
+  return err;
+}
+
+int out_of_range_test(const Cartridge &cart) {
+  std::vector<std::function<void()>> reads = {
+    [&]() { cart.read_at(4, 0x4000); },           // no bank 4
+    [&]() { cart.read_at(1, 0x8000); },           // not a rom address
+    [&]() { cart.read_at(1, 0x7fff, 2); },        // past the end of the bank
+    [&]() { cart.read_at(1, 0x3fff, 2); },        // out of bank 0
+    [&]() { cart.read_from_table_at(1, 0x7000, 0x100, 0x10); },
+    [&]() { cart.read_string_at(2, 0x7ff0, 0x50); }, // never terminated
+    [&]() { cart.rom_bytes(0xfff0, 0x20); },
+    [&]() { cart.rom_string(0x10000); }
+  };
+
+  int err = 0;
+  for (std::size_t i = 0; i < reads.size(); ++i) {
+    try {
+      reads[i]();
+      std::cerr << "[ FAIL ] Cartridge read " << i << " did not throw";
+      std::cerr << std::endl;
+      err = 1;
+    } catch (std::out_of_range &e) {}
+  }
+
+  if (!err) {
+    std::cout << "[ PASS ] Cartridge reads out of range" << std::endl;
+  }
+
+  return err;
+}
@@ -0,0 +1,70 @@
+#include <iostream>
+#include <string>
+#include <vector>
+
+#include <cstdint> // std::uint8_t
+
+#include "gbemu/delta.hpp"
+
+int kernel_test(
+  const std::string &name, gbemu::delta::Kernel kernel,
+  std::size_t num_rows, std::size_t num_cols
+);
+
+int main() {
+  std::vector<std::pair<std::string, gbemu::delta::Kernel>> kernels = {
+    {"decode_table", gbemu::delta::decode_table},
+    {"select_kernel()", gbemu::delta::select_kernel()}
+  };
+
+#if defined(__x86_64__)
+  if (gbemu::delta::has_pclmul()) {
+    kernels.push_back({"decode_pclmul", gbemu::delta::decode_pclmul});
+  }
+  if (gbemu::delta::has_avx2()) {
+    kernels.push_back({"decode_avx2", gbemu::delta::decode_avx2});
+  }
+#endif
+
+  int err = 0;
+  for (auto &[name, kernel] : kernels) {
+    // every sprite size, plus headers wider than one 64-bit row
+    err |= kernel_test(name, kernel, 8, 1);
+    err |= kernel_test(name, kernel, 40, 5);
+    err |= kernel_test(name, kernel, 48, 6);
+    err |= kernel_test(name, kernel, 56, 7);
+    err |= kernel_test(name, kernel, 32, 4);
+    err |= kernel_test(name, kernel, 120, 15);
+  }
+
+  return err;
+}
+
+int kernel_test(
+  const std::string &name, gbemu::delta::Kernel kernel,
+  std::size_t num_rows, std::size_t num_cols
+) {
+  std::vector<std::uint8_t> expected(num_rows * num_cols);
+
+  std::uint32_t state = 0x1234567 + num_rows;
+  for (auto &b : expected) {
+    state ^= state << 13;
+    state ^= state >> 17;
+    state ^= state << 5;
+    b = state;
+  }
+
+  std::vector<std::uint8_t> plane = expected;
+  gbemu::delta::decode_reference(expected.data(), num_rows, num_cols);
+  kernel(plane.data(), num_rows, num_cols);
+
+  if (plane != expected) {
+    std::cerr << "[ FAIL ] delta::" << name << " " << num_rows << "x";
+    std::cerr << num_cols << std::endl;
+    return 1;
+  }
+
+  std::cout << "[ PASS ] delta::" << name << " " << num_rows << "x";
+  std::cout << num_cols << std::endl;
+  return 0;
+}
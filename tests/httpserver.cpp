@@ -0,0 +1,139 @@
+#include <filesystem>
+#include <iostream>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include <cstdint> // std::uint8_t
+#include <cstring>
+
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+#include "util/httpserver.hpp"
+
+std::string exchange(
+  const std::filesystem::path &socket_path, const std::string &requests
+);
+int keep_alive_test();
+
+int main() {
+  int err = 0;
+
+  err |= keep_alive_test();
+
+  return err;
+}
+
+// sends everything at once and reads until the server closes the connection
+std::string exchange(
+  const std::filesystem::path &socket_path, const std::string &requests
+) {
+  sockaddr_un addr {};
+  addr.sun_family = AF_UNIX;
+  std::strncpy(addr.sun_path, socket_path.c_str(), sizeof(addr.sun_path) - 1);
+
+  int fd = socket(AF_UNIX, SOCK_STREAM, 0);
+  if (connect(fd, reinterpret_cast<sockaddr *>(&addr), sizeof(addr)) < 0) {
+    close(fd);
+    return "";
+  }
+
+  if (send(fd, requests.data(), requests.size(), MSG_NOSIGNAL) < 0) {
+    close(fd);
+    return "";
+  }
+
+  std::string response;
+  char buffer[4096];
+  ssize_t n;
+  while ((n = recv(fd, buffer, sizeof(buffer), 0)) > 0) {
+    response.append(buffer, n);
+  }
+
+  close(fd);
+  return response;
+}
+
+int keep_alive_test() {
+  std::filesystem::path socket_path = std::filesystem::temp_directory_path();
+  socket_path /= "pkmn_sprite_http_test.sock";
+
+  HttpServer server([](const HttpRequest &request) {
+    if (request.target == "/missing") {
+      return HttpResponse::text(404, "not found");
+    }
+    return HttpResponse::text(200, request.target);
+  });
+
+  if (server.listen("unix:" + socket_path.string())) {
+    std::cerr << "[ FAIL ] HttpServer.listen()" << std::endl;
+    return 1;
+  }
+  server.start();
+
+  // three pipelined requests on one connection, the last one closes it
+  std::string pipelined = exchange(
+    socket_path,
+    "GET /a HTTP/1.1\r\nHost: x\r\n\r\n"
+    "GET /missing HTTP/1.1\r\n\r\n"
+    "GET /b?c HTTP/1.1\r\nConnection: close\r\n\r\n"
+  );
+
+  std::string expected =
+    "HTTP/1.1 200 OK\r\nContent-Type: text/plain\r\nContent-Length: 3\r\n"
+    "Connection: keep-alive\r\n\r\n/a\n"
+    "HTTP/1.1 404 Not Found\r\nContent-Type: text/plain\r\n"
+    "Content-Length: 10\r\nConnection: keep-alive\r\n\r\nnot found\n"
+    "HTTP/1.1 200 OK\r\nContent-Type: text/plain\r\nContent-Length: 5\r\n"
+    "Connection: close\r\n\r\n/b?c\n";
+
+  // no body for HEAD, HTTP/1.0 closes by default
+  std::string head = exchange(socket_path, "HEAD /a HTTP/1.0\r\n\r\n");
+  std::string expected_head =
+    "HTTP/1.1 200 OK\r\nContent-Type: text/plain\r\nContent-Length: 3\r\n"
+    "Connection: close\r\n\r\n";
+
+  std::string post = exchange(
+    socket_path, "POST /a HTTP/1.1\r\nConnection: close\r\n\r\n"
+  );
+
+  LatencySummary latency = server.latency().summary();
+  server.stop();
+
+  int err = 0;
+  if (pipelined != expected) {
+    std::cerr << "[ FAIL ] HttpServer keep-alive, got\n" << pipelined;
+    std::cerr << std::endl;
+    err = 1;
+  }
+
+  if (head != expected_head) {
+    std::cerr << "[ FAIL ] HttpServer HEAD, got\n" << head << std::endl;
+    err = 1;
+  }
+
+  if (!post.starts_with("HTTP/1.1 405 ")) {
+    std::cerr << "[ FAIL ] HttpServer POST, got\n" << post << std::endl;
+    err = 1;
+  }
+
+  if (latency.count != 5) {
+    std::cerr << "[ FAIL ] HttpServer recorded " << latency.count;
+    std::cerr << " requests" << std::endl;
+    err = 1;
+  }
+
+  if (std::filesystem::exists(socket_path)) {
+    std::cerr << "[ FAIL ] HttpServer.stop() left " << socket_path;
+    std::cerr << std::endl;
+    err = 1;
+  }
+
+  if (!err) {
+    std::cout << "[ PASS ] HttpServer keep-alive" << std::endl;
+  }
+
+  return err;
+}
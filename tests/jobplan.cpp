@@ -0,0 +1,234 @@
+#include <algorithm>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <tuple>
+#include <vector>
+
+#include <cstdint> // std::uint8_t
+
+#include "gbemu/cartridge.hpp"
+#include "gbemu/jobplan.hpp"
+#include "gbemu/romindex.hpp"
+#include "gbemu/romprofile.hpp"
+
+struct TestSprite {
+  std::uint8_t bank;
+  std::uint16_t offset;
+};
+
+// internal ids 1 to 8, id 5 is missingno. Shared sprites and offsets out
+// of id order, so the plan has something to sort.
+const std::vector<TestSprite> sprites = {
+  {3, 0x4200}, {2, 0x4800}, {2, 0x4100}, {3, 0x4200},
+  {2, 0x4000}, {2, 0x4100}, {3, 0x4000}, {2, 0x7f00}
+};
+
+std::filesystem::path write_rom();
+pkmnred::RomProfile test_profile();
+int plan_test(const pkmnred::RomIndex &rom_index);
+int window_test(const pkmnred::RomIndex &rom_index);
+
+int main() {
+  Cartridge cart;
+  if (cart.load_rom(write_rom())) {
+    std::cerr << "[ FAIL ] Cartridge.load_rom()" << std::endl;
+    return 1;
+  }
+
+  pkmnred::RomIndex rom_index;
+  rom_index.build(cart, test_profile());
+
+  int err = 0;
+
+  err |= plan_test(rom_index);
+  err |= window_test(rom_index);
+
+  return err;
+}
+
+// every table in bank 1, every string empty
+std::filesystem::path write_rom() {
+  std::vector<std::uint8_t> rom(0x4000 * 4, 0x00);
+  auto at = [&](std::uint16_t offset) -> std::uint8_t & {
+    return rom[0x4000 + (offset - 0x4000)];
+  };
+
+  for (std::size_t i = 0; i < sprites.size(); ++i) {
+    // pokedex numbers run backwards, stats are indexed by them
+    std::uint8_t dexno = sprites.size() - i;
+    at(0x4000 + i) = dexno;
+
+    std::uint16_t row = 0x4100 + ((dexno - 1) * 28);
+    at(row + 11) = sprites[i].offset & 0xff;
+    at(row + 12) = sprites[i].offset >> 8;
+
+    at(0x4700 + (i * 2)) = 0x00;
+    at(0x4700 + (i * 2) + 1) = 0x48;
+  }
+
+  for (std::uint16_t offset = 0x4400; offset < 0x4500; ++offset) {
+    at(offset) = pkmnred::eos_char;
+  }
+  at(0x4500) = 0x10;
+  at(0x4501) = 0x45;
+  at(0x4510) = pkmnred::eos_char;
+  at(0x4600) = pkmnred::eos_char;
+
+  // pokedex data: an empty type name, then the entry pointer in bytes 5
+  // and 6 of the data after it
+  at(0x4800) = pkmnred::eos_char;
+  at(0x4806) = 0x00;
+  at(0x4807) = 0x49;
+  at(0x4901) = pkmnred::eos_char;
+
+  std::filesystem::path path = std::filesystem::temp_directory_path();
+  path /= "pkmn_sprite_jobplan_test.gb";
+
+  std::ofstream ofs(path, std::ios::binary);
+  ofs.write(reinterpret_cast<const char *>(rom.data()), rom.size());
+
+  return path;
+}
+
+pkmnred::RomProfile test_profile() {
+  pkmnred::RomProfile profile;
+  profile.name = "Job Plan Test";
+  profile.minimum_index = 1;
+  profile.maximum_index = sprites.size();
+  profile.dex_count = sprites.size();
+  profile.missingno = {5};
+
+  for (const TestSprite &sprite : sprites) {
+    profile.sprite_banks.push_back(sprite.bank);
+  }
+
+  profile.pokedex_order_table = {1, 0x4000, 1};
+  profile.pokemon_stats_table = {1, 0x4100, 28};
+  profile.pokemon_names_table = {1, 0x4400, 10};
+  profile.type_names_pointers = {1, 0x4500, 2};
+  profile.move_names = {1, 0x4600, 1};
+  profile.pokedex_data_pointers = {1, 0x4700, 2};
+  profile.pokedex_entries_bank = 1;
+
+  return profile;
+}
+
+int plan_test(const pkmnred::RomIndex &rom_index) {
+  // missingno and ids outside the table come first, in input order
+  std::vector<std::uint8_t> ids = {7, 5, 1, 3, 0, 8, 6, 4, 2, 200};
+  std::vector<pkmnred::SpriteJob> plan = pkmnred::plan_jobs(rom_index, ids);
+
+  int err = 0;
+  if (plan.size() != ids.size()) {
+    std::cerr << "[ FAIL ] plan_jobs() returned " << plan.size();
+    std::cerr << " jobs for " << ids.size() << " ids" << std::endl;
+    return 1;
+  }
+
+  // every input row exactly once, with its own id
+  std::vector<int> seen(ids.size(), 0);
+  for (const pkmnred::SpriteJob &job : plan) {
+    if ((job.row >= ids.size()) || (job.pokemon_id != ids[job.row])) {
+      err = 1;
+      continue;
+    }
+    ++seen[job.row];
+
+    if (
+      rom_index.contains(job.pokemon_id) && (
+        (job.bank != sprites[job.pokemon_id - 1].bank) ||
+        (job.offset != sprites[job.pokemon_id - 1].offset)
+      )
+    ) {
+      err = 1;
+    }
+  }
+  if (std::count(seen.begin(), seen.end(), 1) != int(ids.size())) {
+    err = 1;
+  }
+
+  if (err) {
+    std::cerr << "[ FAIL ] plan_jobs() rows" << std::endl;
+    return 1;
+  }
+
+  // unknown ids have bank 0, so sorting by (bank, offset, row) puts them
+  // first as well
+  for (std::size_t i = 1; i < plan.size(); ++i) {
+    const pkmnred::SpriteJob &a = plan[i - 1];
+    const pkmnred::SpriteJob &b = plan[i];
+
+    if (
+      std::tie(a.bank, a.offset, a.row) >= std::tie(b.bank, b.offset, b.row)
+    ) {
+      std::cerr << "[ FAIL ] plan_jobs() order at job " << i << std::endl;
+      return 1;
+    }
+  }
+
+  std::vector<std::uint8_t> unknown;
+  for (std::size_t i = 0; i < 3; ++i) {
+    unknown.push_back(plan[i].pokemon_id);
+  }
+  if (unknown != std::vector<std::uint8_t>{5, 0, 200}) {
+    std::cerr << "[ FAIL ] plan_jobs() unknown ids" << std::endl;
+    return 1;
+  }
+
+  std::cout << "[ PASS ] plan_jobs()" << std::endl;
+  return 0;
+}
+
+int window_test(const pkmnred::RomIndex &rom_index) {
+  std::vector<std::uint8_t> ids = {7, 5, 1, 3, 0, 8, 6, 4, 2, 200};
+  constexpr std::size_t window = 4;
+  std::vector<pkmnred::SpriteJob> plan = pkmnred::plan_jobs(
+    rom_index, ids, window
+  );
+
+  if (plan.size() != ids.size()) {
+    std::cerr << "[ FAIL ] plan_jobs() window returned " << plan.size();
+    std::cerr << " jobs for " << ids.size() << " ids" << std::endl;
+    return 1;
+  }
+
+  // job i comes from the window of row i, sorted by (bank, offset, row)
+  // inside it, and the last window is the short one
+  for (std::size_t i = 0; i < plan.size(); ++i) {
+    const pkmnred::SpriteJob &job = plan[i];
+
+    if (
+      (job.row >= ids.size()) || (job.pokemon_id != ids[job.row]) ||
+      ((job.row / window) != (i / window))
+    ) {
+      std::cerr << "[ FAIL ] plan_jobs() window row at job " << i;
+      std::cerr << std::endl;
+      return 1;
+    }
+
+    if ((i % window) != 0) {
+      const pkmnred::SpriteJob &a = plan[i - 1];
+      if (
+        std::tie(a.bank, a.offset, a.row) >=
+          std::tie(job.bank, job.offset, job.row)
+      ) {
+        std::cerr << "[ FAIL ] plan_jobs() window order at job " << i;
+        std::cerr << std::endl;
+        return 1;
+      }
+    }
+  }
+
+  std::vector<std::uint8_t> order;
+  for (const pkmnred::SpriteJob &job : plan) {
+    order.push_back(job.pokemon_id);
+  }
+  if (order != std::vector<std::uint8_t>{5, 3, 7, 1, 0, 6, 8, 4, 200, 2}) {
+    std::cerr << "[ FAIL ] plan_jobs() window order" << std::endl;
+    return 1;
+  }
+
+  std::cout << "[ PASS ] plan_jobs() window" << std::endl;
+  return 0;
+}
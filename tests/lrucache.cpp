@@ -0,0 +1,90 @@
+#include <iostream>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include <cstdint> // std::uint8_t
+
+#include "util/latency.hpp"
+#include "util/lrucache.hpp"
+
+LruCache::Value make_value(std::size_t size);
+int eviction_test();
+int latency_test();
+
+int main() {
+  int err = 0;
+
+  err |= eviction_test();
+  err |= latency_test();
+
+  return err;
+}
+
+LruCache::Value make_value(std::size_t size) {
+  return std::make_shared<std::vector<std::uint8_t>>(size, 0xab);
+}
+
+int eviction_test() {
+  // room for three 99 byte values with their 1 byte keys
+  LruCache cache(300);
+
+  cache.insert("a", make_value(99));
+  cache.insert("b", make_value(99));
+  cache.insert("c", make_value(99));
+
+  // "a" is now the most recently used, so "b" goes first
+  bool found_a = (cache.find("a") != nullptr);
+  cache.insert("d", make_value(99));
+
+  bool evicted = (cache.find("b") == nullptr);
+  bool kept = (cache.find("a") && cache.find("c") && cache.find("d"));
+
+  // too big to ever fit, the cache is left alone
+  cache.insert("e", make_value(300));
+  bool skipped = (cache.find("e") == nullptr) && (cache.size() == 3);
+
+  // replacing a value does not count it twice
+  cache.insert("d", make_value(50));
+  bool replaced = (cache.bytes() == 100 + 100 + 51);
+
+  if (!found_a || !evicted || !kept || !skipped || !replaced) {
+    std::cerr << "[ FAIL ] LruCache eviction" << std::endl;
+    return 1;
+  }
+
+  if ((cache.hits() != 4) || (cache.misses() != 2)) {
+    std::cerr << "[ FAIL ] LruCache hits " << cache.hits() << " misses ";
+    std::cerr << cache.misses() << std::endl;
+    return 1;
+  }
+
+  std::cout << "[ PASS ] LruCache eviction" << std::endl;
+  return 0;
+}
+
+int latency_test() {
+  LatencyStats stats(100);
+
+  // older samples fall out of the window
+  for (std::uint64_t i = 0; i < 50; ++i) {
+    stats.record(1000000);
+  }
+  for (std::uint64_t i = 1; i <= 100; ++i) {
+    stats.record(i);
+  }
+
+  LatencySummary summary = stats.summary();
+  if (
+    (summary.count != 150) || (summary.p50 != 50) || (summary.p99 != 99) ||
+    (summary.max != 100)
+  ) {
+    std::cerr << "[ FAIL ] LatencyStats.summary() p50 " << summary.p50;
+    std::cerr << " p99 " << summary.p99 << " max " << summary.max;
+    std::cerr << std::endl;
+    return 1;
+  }
+
+  std::cout << "[ PASS ] LatencyStats.summary()" << std::endl;
+  return 0;
+}
@@ -0,0 +1,174 @@
+#include <algorithm>
+#include <array>
+#include <iostream>
+#include <vector>
+
+#include <cstdint> // std::uint8_t
+
+#include "gbemu/rasteriser.hpp"
+#include "gbemu/spriteencoder.hpp"
+#include "lib/pkmnsprite.h"
+
+std::vector<std::uint8_t> make_rom(
+  const gbemu::EncodedSprite &encoded, std::uint8_t bank,
+  std::uint16_t offset
+);
+int decode_test();
+int error_test();
+
+int main() {
+  int err = 0;
+
+  err |= decode_test();
+  err |= error_test();
+
+  return err;
+}
+
+// four banks, the sprite at bank:offset and nothing else
+std::vector<std::uint8_t> make_rom(
+  const gbemu::EncodedSprite &encoded, std::uint8_t bank,
+  std::uint16_t offset
+) {
+  std::vector<std::uint8_t> rom(0x4000 * 4, 0x00);
+  std::size_t start = (bank * 0x4000) + (offset - 0x4000);
+  for (std::size_t i = 0; i < encoded.data.size(); ++i) {
+    if (start + i < rom.size()) {
+      rom[start + i] = encoded.data[i];
+    }
+  }
+
+  return rom;
+}
+
+int decode_test() {
+  // a diagonal stripe in every colour
+  gbemu::SpriteImage image;
+  image.width = 5;
+  image.height = 6;
+  for (std::size_t i = 0; i < (image.width * image.height * 8); ++i) {
+    image.low[i] = 0x81 >> (i % 8);
+    image.high[i] = 0x18 << (i % 4);
+  }
+
+  gbemu::Encoder encoder;
+  gbemu::EncodedSprite encoded = encoder.encode(image);
+  std::vector<std::uint8_t> rom = make_rom(encoded, 3, 0x5123);
+
+  std::uint8_t tiles[PKMNSPRITE_MAX_TILE_BYTES];
+  pkmnsprite_info info;
+  int status = pkmnsprite_decode_sprite(
+    {rom.data(), rom.size()}, 3, 0x5123, tiles, sizeof(tiles), &info
+  );
+
+  gbemu::SpriteImage decoded = gbemu::image_from_tiles(
+    std::span<const std::uint8_t>(tiles, info.size), info.width, info.height
+  );
+
+  if (
+    (status != PKMNSPRITE_OK) || (info.size != 5 * 6 * 16) ||
+    (info.encoding_mode != encoded.encoding_mode) ||
+    (decoded.low != image.low) || (decoded.high != image.high)
+  ) {
+    std::cerr << "[ FAIL ] pkmnsprite_decode_sprite() status " << status;
+    std::cerr << std::endl;
+    return 1;
+  }
+
+  std::uint8_t pixels[PKMNSPRITE_IMAGE_BYTES];
+  std::array<std::uint8_t, gbemu::RASTER_SIZE> expected;
+  status = pkmnsprite_rasterise(
+    tiles, info.size, info.width, info.height, 0, pixels, sizeof(pixels)
+  );
+  gbemu::rasterise(
+    std::span<const std::uint8_t>(tiles, info.size), info.width, info.height,
+    expected
+  );
+
+  if (
+    (status != PKMNSPRITE_OK) ||
+    !std::equal(expected.begin(), expected.end(), pixels)
+  ) {
+    std::cerr << "[ FAIL ] pkmnsprite_rasterise() status " << status;
+    std::cerr << std::endl;
+    return 1;
+  }
+
+  std::cout << "[ PASS ] pkmnsprite_decode_sprite()" << std::endl;
+  return 0;
+}
+
+int error_test() {
+  gbemu::SpriteImage image;
+  image.width = 7;
+  image.height = 7;
+  image.low.fill(0x5a);
+
+  gbemu::Encoder encoder;
+  gbemu::EncodedSprite encoded = encoder.encode(image);
+  std::vector<std::uint8_t> rom = make_rom(encoded, 1, 0x4000);
+  pkmnsprite_rom_view view = {rom.data(), rom.size()};
+
+  // the same sprite, cut off by the end of the last bank
+  std::vector<std::uint8_t> cut = make_rom(encoded, 3, 0x7ff0);
+  pkmnsprite_rom_view cut_view = {cut.data(), cut.size()};
+
+  // a header that says 8x8 tiles
+  std::vector<std::uint8_t> large = rom;
+  large[0x4000] = 0x88;
+  pkmnsprite_rom_view large_view = {large.data(), large.size()};
+
+  std::uint8_t tiles[PKMNSPRITE_MAX_TILE_BYTES];
+  pkmnsprite_info info;
+
+  struct Case {
+    int expected;
+    int status;
+  };
+
+  std::vector<Case> cases = {
+    {PKMNSPRITE_INVALID_ARGUMENT, pkmnsprite_decode_sprite(
+      {nullptr, 0}, 1, 0x4000, tiles, sizeof(tiles), nullptr
+    )},
+    {PKMNSPRITE_BANK_OUT_OF_RANGE, pkmnsprite_decode_sprite(
+      view, 4, 0x4000, tiles, sizeof(tiles), nullptr
+    )},
+    {PKMNSPRITE_OFFSET_OUT_OF_RANGE, pkmnsprite_decode_sprite(
+      view, 1, 0x3fff, tiles, sizeof(tiles), nullptr
+    )},
+    {PKMNSPRITE_INVALID_SPRITE, pkmnsprite_decode_sprite(
+      large_view, 1, 0x4000, tiles, sizeof(tiles), nullptr
+    )},
+    {PKMNSPRITE_TRUNCATED, pkmnsprite_decode_sprite(
+      cut_view, 3, 0x7ff0, tiles, sizeof(tiles), nullptr
+    )},
+    {PKMNSPRITE_BUFFER_TOO_SMALL, pkmnsprite_decode_sprite(
+      view, 1, 0x4000, tiles, 100, &info
+    )},
+    {PKMNSPRITE_BUFFER_TOO_SMALL, pkmnsprite_rasterise(
+      tiles, sizeof(tiles), 7, 7, 1, tiles, sizeof(tiles)
+    )}
+  };
+
+  int err = 0;
+  for (std::size_t i = 0; i < cases.size(); ++i) {
+    if (cases[i].status != cases[i].expected) {
+      std::cerr << "[ FAIL ] pkmnsprite case " << i << " returned ";
+      std::cerr << cases[i].status << ", expected " << cases[i].expected;
+      std::cerr << std::endl;
+      err = 1;
+    }
+  }
+
+  // enough of the header to retry with a large enough buffer
+  if (info.size != PKMNSPRITE_MAX_TILE_BYTES) {
+    std::cerr << "[ FAIL ] pkmnsprite_info.size " << info.size << std::endl;
+    err = 1;
+  }
+
+  if (!err) {
+    std::cout << "[ PASS ] pkmnsprite errors" << std::endl;
+  }
+
+  return err;
+}
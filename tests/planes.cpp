@@ -0,0 +1,109 @@
+#include <array>
+#include <iostream>
+#include <span>
+
+#include <cstdint> // std::uint8_t
+
+#include "gbemu/planes.hpp"
+#include "gbemu/spritedecoder.hpp"
+
+void fill_random(std::uint8_t *plane, std::uint32_t &state);
+int xor_into_test(std::uint32_t &state);
+int finalise_test(std::uint32_t &state);
+
+int main() {
+  int err = 0;
+
+  std::uint32_t state = 1;
+  err |= xor_into_test(state);
+  err |= finalise_test(state);
+
+  return err;
+}
+
+// the padding too, the kernels work on whole planes
+void fill_random(std::uint8_t *plane, std::uint32_t &state) {
+  for (std::size_t i = 0; i < gbemu::PLANE_STRIDE; ++i) {
+    state ^= state << 13;
+    state ^= state >> 17;
+    state ^= state << 5;
+    plane[i] = state >> 8;
+  }
+}
+
+int xor_into_test(std::uint32_t &state) {
+  for (std::size_t n = 0; n < 16; ++n) {
+    gbemu::PlaneBuffer buffer;
+    fill_random(buffer.plane(0), state);
+    fill_random(buffer.plane(1), state);
+
+    std::array<std::uint8_t, gbemu::PLANE_STRIDE> expected;
+    for (std::size_t i = 0; i < expected.size(); ++i) {
+      expected[i] = buffer.plane(0)[i] ^ buffer.plane(1)[i];
+    }
+
+    gbemu::planes::xor_into(buffer.plane(0), buffer.plane(1));
+
+    for (std::size_t i = 0; i < expected.size(); ++i) {
+      if (buffer.plane(0)[i] != expected[i]) {
+        std::cerr << "[ FAIL ] planes::xor_into() byte " << i << std::endl;
+        return 1;
+      }
+    }
+  }
+
+  std::cout << "[ PASS ] planes::xor_into()" << std::endl;
+  return 0;
+}
+
+int finalise_test(std::uint32_t &state) {
+  for (std::uint8_t mode = 1; mode <= 3; ++mode) {
+    for (bool swap : {false, true}) {
+      for (std::size_t n = 0; n < 16; ++n) {
+        gbemu::Decoder decoder(std::span<const std::uint8_t>{});
+        decoder.encoding_mode = mode;
+        decoder.swap_buffers = swap;
+        decoder.primary_buffer = swap ? 2 : 1;
+        decoder.secondary_buffer = swap ? 1 : 2;
+        fill_random(decoder.scratch.plane(1), state);
+        fill_random(decoder.scratch.plane(2), state);
+
+        // the scalar path finalise() replaced: XOR the primary plane into
+        // the secondary one (modes 2 and 3), then zip low and high bytes
+        std::array<std::uint8_t, gbemu::PLANE_SIZE> low;
+        std::array<std::uint8_t, gbemu::PLANE_SIZE> high;
+        for (std::size_t i = 0; i < gbemu::PLANE_SIZE; ++i) {
+          low[i] = decoder.scratch.plane(1)[i];
+          high[i] = decoder.scratch.plane(2)[i];
+        }
+        if (mode != 1) {
+          if (swap) {
+            for (std::size_t i = 0; i < low.size(); ++i) {
+              low[i] ^= high[i];
+            }
+          } else {
+            for (std::size_t i = 0; i < high.size(); ++i) {
+              high[i] ^= low[i];
+            }
+          }
+        }
+
+        std::array<std::uint8_t, gbemu::SPRITE_SIZE> output;
+        decoder.finalise(output);
+
+        for (std::size_t i = 0; i < gbemu::PLANE_SIZE; ++i) {
+          if (
+            (output[i * 2] != low[i]) || (output[(i * 2) + 1] != high[i])
+          ) {
+            std::cerr << "[ FAIL ] Decoder.finalise() mode " << int(mode);
+            std::cerr << " swap " << swap << " byte " << i << std::endl;
+            return 1;
+          }
+        }
+      }
+    }
+  }
+
+  std::cout << "[ PASS ] Decoder.finalise() every mode and swap" << std::endl;
+  return 0;
+}
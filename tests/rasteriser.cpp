@@ -0,0 +1,151 @@
+#include <array>
+#include <iostream>
+#include <stdexcept>
+#include <vector>
+
+#include <cstdint> // std::uint8_t
+
+#include "gbemu/rasteriser.hpp"
+#include "gbemu/spriterenderer.hpp"
+#include "util/image.hpp"
+
+std::vector<std::uint8_t> random_tiles(
+  std::uint8_t width, std::uint8_t height, std::uint32_t &state
+);
+int rasterise_test(
+  const std::vector<std::uint8_t> &tiles, std::uint8_t width,
+  std::uint8_t height
+);
+int rasterise_doubled_test(
+  const std::vector<std::uint8_t> &tiles, std::uint8_t width,
+  std::uint8_t height
+);
+int palette_test();
+
+int main() {
+  int err = 0;
+
+  std::uint32_t state = 1;
+  for (std::uint8_t width = 1; width <= 7; ++width) {
+    for (std::uint8_t height = 1; height <= 7; ++height) {
+      for (std::size_t n = 0; n < 4; ++n) {
+        std::vector<std::uint8_t> tiles = random_tiles(width, height, state);
+        err |= rasterise_test(tiles, width, height);
+        err |= rasterise_doubled_test(tiles, width, height);
+      }
+    }
+  }
+
+  if (!err) {
+    std::cout << "[ PASS ] rasterise() 1x1 to 7x7" << std::endl;
+    std::cout << "[ PASS ] rasterise_doubled() 1x1 to 7x7" << std::endl;
+  }
+
+  err |= palette_test();
+
+  return err;
+}
+
+std::vector<std::uint8_t> random_tiles(
+  std::uint8_t width, std::uint8_t height, std::uint32_t &state
+) {
+  std::vector<std::uint8_t> tiles(width * height * 16);
+  for (std::uint8_t &b : tiles) {
+    state ^= state << 13;
+    state ^= state >> 17;
+    state ^= state << 5;
+    b = state >> 8;
+  }
+
+  return tiles;
+}
+
+int rasterise_test(
+  const std::vector<std::uint8_t> &tiles, std::uint8_t width,
+  std::uint8_t height
+) {
+  // the stages rasterise() replaced, compared through the same encoding
+  gbemu::Renderer staged(tiles, width, height);
+  staged.interlace();
+  staged.expand();
+  staged.add_padding();
+  staged.transpose();
+
+  std::array<std::uint8_t, gbemu::RASTER_SIZE> raster;
+  gbemu::Renderer fused(tiles, width, height);
+  fused.render(raster);
+
+  if (
+    staged.encode(gbemu::IMAGE_FORMAT::PGM) !=
+    fused.encode(gbemu::IMAGE_FORMAT::PGM)
+  ) {
+    std::cerr << "[ FAIL ] rasterise() " << int(width) << "x" << int(height);
+    std::cerr << std::endl;
+    return 1;
+  }
+
+  return 0;
+}
+
+int rasterise_doubled_test(
+  const std::vector<std::uint8_t> &tiles, std::uint8_t width,
+  std::uint8_t height
+) {
+  std::array<std::uint8_t, gbemu::RASTER_SIZE> output;
+  gbemu::rasterise_doubled(tiles, width, height, output);
+
+  // one pixel at a time straight from the tile data, top left aligned and
+  // cropped to the box
+  std::size_t num_rows = height * 8;
+  for (std::size_t y = 0; y < gbemu::RASTER_HEIGHT; ++y) {
+    for (std::size_t x = 0; x < gbemu::RASTER_WIDTH; ++x) {
+      std::size_t sx = x / 2;
+      std::size_t sy = y / 2;
+
+      std::uint8_t expected = 0;
+      if ((sx < std::size_t(width * 8)) && (sy < num_rows)) {
+        std::size_t index = (((sx / 8) * num_rows) + sy) * 2;
+        std::size_t bit = 7 - (sx % 8);
+        expected = ((tiles[index] >> bit) & 0b1);
+        expected |= ((tiles[index + 1] >> bit) & 0b1) << 1;
+      }
+
+      if (output[(y * gbemu::RASTER_WIDTH) + x] != expected) {
+        std::cerr << "[ FAIL ] rasterise_doubled() " << int(width) << "x";
+        std::cerr << int(height) << " at " << x << "," << y << std::endl;
+        return 1;
+      }
+    }
+  }
+
+  return 0;
+}
+
+int palette_test() {
+  std::array<std::uint8_t, 64> tiles {};
+  gbemu::Renderer renderer(tiles, 2, 2);
+
+  try {
+    renderer.set_palette({{0xff, 0xff, 0xff}, {0x00, 0x00, 0x00}});
+    std::cerr << "[ FAIL ] Renderer.set_palette() took 2 colours";
+    std::cerr << std::endl;
+    return 1;
+  } catch (std::invalid_argument &e) {}
+
+  // the PLTE chunk follows the signature and IHDR, 4 entries whatever the
+  // palette
+  std::array<std::uint8_t, 16> pixels {};
+  std::vector<std::uint8_t> png = encode_png(pixels, 4, 4, {{1, 2, 3}});
+  std::vector<std::uint8_t> plte(png.begin() + 33, png.begin() + 53);
+  std::vector<std::uint8_t> expected = {
+    0, 0, 0, 12, 'P', 'L', 'T', 'E', 1, 2, 3, 0, 0, 0, 0, 0, 0, 0, 0, 0
+  };
+
+  if (plte != expected) {
+    std::cerr << "[ FAIL ] encode_png() short palette" << std::endl;
+    return 1;
+  }
+
+  std::cout << "[ PASS ] palettes shorter than 4 colours" << std::endl;
+  return 0;
+}
@@ -0,0 +1,115 @@
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "util/report.hpp"
+
+int order_test();
+int format_test();
+
+int main() {
+  int err = 0;
+
+  err |= order_test();
+  err |= format_test();
+
+  return err;
+}
+
+int order_test() {
+  std::vector<ReportColumn> columns = {
+    {"N", "n", {4, 0, false, false}, VALUE_TYPE::NUMBER}
+  };
+
+  std::stringstream ss;
+  Report report(ss, REPORT_FORMAT::CSV, columns);
+  report.write_header();
+
+  // every thread takes every fourth row, backwards, so nearly every row
+  // arrives before the one above it
+  constexpr std::size_t count = 1000;
+  std::vector<std::thread> threads;
+  for (std::size_t t = 0; t < 4; ++t) {
+    threads.emplace_back([&report, t]() {
+      for (std::size_t i = count - 4 + t; i < count; i -= 4) {
+        report.submit(i, {std::to_string(i)});
+      }
+    });
+  }
+
+  for (auto& t : threads) {
+    t.join();
+  }
+
+  std::string expected = "N\n";
+  for (std::size_t i = 0; i < count; ++i) {
+    expected += std::to_string(i) + "\n";
+  }
+
+  if (ss.str() != expected) {
+    std::cerr << "[ FAIL ] Report.submit() out of order" << std::endl;
+    return 1;
+  }
+
+  std::cout << "[ PASS ] Report.submit()" << std::endl;
+  return 0;
+}
+
+int format_test() {
+  std::vector<ReportColumn> columns = {
+    {"NAME", "name", {8, 0, true, false}, VALUE_TYPE::STRING},
+    {"ID", "id", {4, 0, false, false}, VALUE_TYPE::NUMBER},
+    {"SWAP?", "swap", {5, 0, true, false}, VALUE_TYPE::BOOL}
+  };
+  std::vector<std::string> row = {"MR.\"MIME\",\x01", "122", "false"};
+
+  std::stringstream json;
+  Report json_report(json, REPORT_FORMAT::NDJSON, columns);
+  json_report.write_header();
+  json_report.submit(0, row);
+
+  std::string expected_json =
+    "{\"name\":\"MR.\\\"MIME\\\",\\u0001\",\"id\":122,\"swap\":false}\n";
+
+  std::stringstream csv;
+  Report csv_report(csv, REPORT_FORMAT::CSV, columns);
+  csv_report.write_header();
+  csv_report.submit(0, row);
+
+  std::string expected_csv =
+    "NAME,ID,SWAP?\n\"MR.\"\"MIME\"\",\x01\",122,false\n";
+
+  std::stringstream table;
+  Report table_report(table, REPORT_FORMAT::TABLE, columns);
+  table_report.write_header();
+  table_report.submit(0, {"ABRA", "148", "true"});
+
+  std::string expected_table =
+    "NAME     | ID   | SWAP?\n"
+    "---------+------+------\n"
+    "ABRA     |  148 | true \n";
+
+  int err = 0;
+  if (json.str() != expected_json) {
+    std::cerr << "[ FAIL ] Report ndjson: got " << json.str() << std::endl;
+    err = 1;
+  }
+
+  if (csv.str() != expected_csv) {
+    std::cerr << "[ FAIL ] Report csv: got " << csv.str() << std::endl;
+    err = 1;
+  }
+
+  if (table.str() != expected_table) {
+    std::cerr << "[ FAIL ] Report table: got\n" << table.str() << std::endl;
+    err = 1;
+  }
+
+  if (!err) {
+    std::cout << "[ PASS ] Report formats" << std::endl;
+  }
+
+  return err;
+}
@@ -0,0 +1,162 @@
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <stdexcept>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include <cstdint> // std::uint8_t
+
+#include "gbemu/cartridge.hpp"
+#include "gbemu/romprofile.hpp"
+
+std::vector<std::uint8_t> make_header(
+  const std::string &title, std::uint16_t checksum
+);
+std::filesystem::path write_profiles(const std::string &text);
+int detect_test();
+int error_test();
+
+int main() {
+  int err = 0;
+
+  err |= detect_test();
+  err |= error_test();
+
+  return err;
+}
+
+std::vector<std::uint8_t> make_header(
+  const std::string &title, std::uint16_t checksum
+) {
+  std::vector<std::uint8_t> bank0(0x4000, 0);
+  for (std::size_t i = 0; i < title.size(); ++i) {
+    bank0[pkmnred::title_address + i] = title[i];
+  }
+  bank0[pkmnred::global_checksum_address] = checksum >> 8;
+  bank0[pkmnred::global_checksum_address + 1] = checksum & 0xff;
+
+  return bank0;
+}
+
+std::filesystem::path write_profiles(const std::string &text) {
+  std::filesystem::path path = std::filesystem::temp_directory_path();
+  path /= "pkmn_sprite_profiles_test.txt";
+
+  std::ofstream ofs(path);
+  ofs << text;
+
+  return path;
+}
+
+int detect_test() {
+  std::string text =
+    "# a build that differs from red in one table\n"
+    "[Test Red]\n"
+    "title POKEMON RED\n"
+    "checksum 0x1234\n"
+    "index_range 1 3\n"
+    "dex_count 0x02\n"
+    "missingno 2\n"
+    "sprite_banks 09 09\n"
+    "sprite_banks 0a\n"
+    "type_names 09:7dae\n"
+    "pokedex_data 10:447e\n"
+    "pokemon_stats 0e:43de 1c\n"
+    "pokedex_order 10:5024 1\n"
+    "pokemon_names 07:4000 0a   # moved\n"
+    "move_names 2c:4000 a5\n"
+    "pokedex_entries 2b\n";
+
+  pkmnred::ProfileRegistry registry;
+  std::size_t count = registry.load(write_profiles(text));
+
+  std::vector<std::uint8_t> matching = make_header("POKEMON RED", 0x1234);
+  std::vector<std::uint8_t> other = make_header("POKEMON RED", 0x4321);
+  std::vector<std::uint8_t> unknown = make_header("POKEMON BLUE", 0x1234);
+
+  Cartridge cart;
+  cart.bank0 = matching;
+  const pkmnred::RomProfile *with_checksum = registry.detect(cart);
+  cart.bank0 = other;
+  const pkmnred::RomProfile *title_only = registry.detect(cart);
+  cart.bank0 = unknown;
+  const pkmnred::RomProfile *none = registry.detect(cart);
+
+  int err = 0;
+  if ((count != 1) || (registry.profiles().size() != 2)) {
+    std::cerr << "[ FAIL ] ProfileRegistry.load() read " << count;
+    std::cerr << " profiles" << std::endl;
+    err = 1;
+  }
+
+  if (
+    (with_checksum == nullptr) || (with_checksum->name != "Test Red") ||
+    (with_checksum->sprite_banks.size() != 3) ||
+    (with_checksum->pokemon_names_table.offset != 0x4000) ||
+    (with_checksum->move_names.width != 0xa5)
+  ) {
+    std::cerr << "[ FAIL ] ProfileRegistry.detect() checksum match";
+    std::cerr << std::endl;
+    err = 1;
+  }
+
+  // the built-in profile only has a title
+  if (
+    (title_only == nullptr) ||
+    (title_only->name != pkmnred::red_profile().name)
+  ) {
+    std::cerr << "[ FAIL ] ProfileRegistry.detect() title match" << std::endl;
+    err = 1;
+  }
+
+  if (none != nullptr) {
+    std::cerr << "[ FAIL ] ProfileRegistry.detect() matched " << none->name;
+    std::cerr << std::endl;
+    err = 1;
+  }
+
+  if (!err) {
+    std::cout << "[ PASS ] ProfileRegistry.detect()" << std::endl;
+  }
+
+  return err;
+}
+
+int error_test() {
+  std::vector<std::pair<std::string, std::string>> cases = {
+    {"title POKEMON RED\n", ":1: "},
+    {"[A]\ntitle A\n\nindex_range 1 zz\n", ":4: "},
+    {"[A]\ntitle A\npokemon_stats 0e43de 1c\n", ":3: "},
+    {"[A]\ntitle A\ncolour red\n", ":3: "},
+    // incomplete profiles are reported at their section
+    {"\n[A]\ntitle A\nindex_range 1 3\n", ":2: "}
+  };
+
+  int err = 0;
+  for (auto &[text, expected] : cases) {
+    pkmnred::ProfileRegistry registry;
+    std::string message;
+    try {
+      registry.load(write_profiles(text));
+    } catch (std::runtime_error &e) {
+      message = e.what();
+    }
+
+    if (
+      (message.find(expected) == std::string::npos) ||
+      (registry.profiles().size() != 1)
+    ) {
+      std::cerr << "[ FAIL ] ProfileRegistry.load() expected " << expected;
+      std::cerr << " got \"" << message << "\"" << std::endl;
+      err = 1;
+    }
+  }
+
+  if (!err) {
+    std::cout << "[ PASS ] ProfileRegistry.load() errors" << std::endl;
+  }
+
+  return err;
+}
@@ -0,0 +1,185 @@
+#include <algorithm>
+#include <array>
+#include <iostream>
+#include <thread>
+#include <vector>
+
+#include <cstdint> // std::uint8_t
+
+#include "gbemu/spritedecoder.hpp"
+#include "gbemu/spriteencoder.hpp"
+
+gbemu::SpriteImage random_image(
+  std::uint8_t width, std::uint8_t height, std::uint32_t &state
+);
+gbemu::SpriteImage decode_image(
+  gbemu::Decoder &decoder, std::uint8_t bank, std::uint16_t offset
+);
+int header_test();
+int shared_rom_test();
+
+int main() {
+  int err = 0;
+
+  err |= header_test();
+  err |= shared_rom_test();
+
+  return err;
+}
+
+// random pixels in runs, so both packet types turn up
+gbemu::SpriteImage random_image(
+  std::uint8_t width, std::uint8_t height, std::uint32_t &state
+) {
+  gbemu::SpriteImage image;
+  image.width = width;
+  image.height = height;
+
+  std::uint8_t low = 0;
+  std::uint8_t high = 0;
+  for (std::size_t i = 0; i < std::size_t(width * height * 8); ++i) {
+    state ^= state << 13;
+    state ^= state >> 17;
+    state ^= state << 5;
+
+    if ((state % 3) == 0) {
+      low = state >> 8;
+      high = state >> 16;
+    }
+    image.low[i] = low;
+    image.high[i] = high;
+  }
+
+  return image;
+}
+
+gbemu::SpriteImage decode_image(
+  gbemu::Decoder &decoder, std::uint8_t bank, std::uint16_t offset
+) {
+  decoder.clear(0);
+  decoder.clear(1);
+  decoder.clear(2);
+  decoder.set_bank(bank);
+  decoder.set_offset(offset);
+  decoder.read_header();
+  decoder.rle_decode(decoder.primary_buffer);
+  decoder.read_encoding_mode();
+  decoder.rle_decode(decoder.secondary_buffer);
+  decoder.delta_decode(decoder.primary_buffer);
+  if (decoder.encoding_mode != 2) {
+    decoder.delta_decode(decoder.secondary_buffer);
+  }
+
+  std::array<std::uint8_t, gbemu::SPRITE_SIZE> tiles;
+  decoder.finalise(tiles);
+
+  return gbemu::image_from_tiles(tiles, decoder.width, decoder.height);
+}
+
+int header_test() {
+  gbemu::SpriteImage image;
+  image.width = 7;
+  image.height = 7;
+  image.low.fill(0xa5);
+
+  gbemu::Encoder encoder;
+  gbemu::EncodedSprite encoded = encoder.encode(image);
+
+  std::vector<std::uint8_t> rom(0x8000, 0x00);
+  std::copy(encoded.data.begin(), encoded.data.end(), rom.begin() + 0x4000);
+
+  // the first byte of a sprite is its width and height in tiles
+  struct Case {
+    std::uint8_t size;
+    bool valid;
+  };
+
+  std::vector<Case> cases = {
+    {0x77, true}, {0x11, true}, {0x17, true}, {0x71, true},
+    {0xff, false}, {0x87, false}, {0x78, false},
+    {0x00, false}, {0x07, false}, {0x70, false}
+  };
+
+  int err = 0;
+  for (const Case &c : cases) {
+    rom[0x4000] = c.size;
+
+    gbemu::Decoder decoder(rom);
+    decoder.set_bank(1);
+    decoder.set_offset(0x4000);
+    if (decoder.read_header() != c.valid) {
+      std::cerr << "[ FAIL ] Decoder.read_header() " << int(decoder.width);
+      std::cerr << "x" << int(decoder.height) << std::endl;
+      err = 1;
+    }
+  }
+
+  if (!err) {
+    std::cout << "[ PASS ] Decoder.read_header()" << std::endl;
+  }
+
+  return err;
+}
+
+int shared_rom_test() {
+  std::vector<gbemu::SpriteImage> images;
+  std::uint32_t state = 1;
+  for (std::uint8_t width = 1; width <= 7; ++width) {
+    for (std::uint8_t height = 1; height <= 7; ++height) {
+      images.push_back(random_image(width, height, state));
+    }
+  }
+
+  // eight sprites to a bank, 0x800 bytes apart
+  std::size_t banks = 1 + ((images.size() + 7) / 8);
+  std::vector<std::uint8_t> rom(0x4000 * banks, 0x00);
+
+  gbemu::Encoder encoder;
+  for (std::size_t i = 0; i < images.size(); ++i) {
+    gbemu::EncodedSprite encoded = encoder.encode(images[i]);
+    std::size_t start = ((1 + (i / 8)) * 0x4000) + ((i % 8) * 0x800);
+    std::copy(encoded.data.begin(), encoded.data.end(), rom.begin() + start);
+  }
+
+  // every thread decodes every sprite from the same rom, each with its own
+  // decoder and nothing else
+  const std::vector<std::uint8_t> &shared = rom;
+  std::vector<int> errors(4, 0);
+
+  auto worker = [&](std::size_t t) {
+    gbemu::Decoder decoder(shared);
+    for (std::size_t pass = 0; pass < 50; ++pass) {
+      for (std::size_t j = 0; j < images.size(); ++j) {
+        // start each thread somewhere else in the rom
+        std::size_t i = (j + (t * 13)) % images.size();
+        gbemu::SpriteImage decoded = decode_image(
+          decoder, 1 + (i / 8), 0x4000 + ((i % 8) * 0x800)
+        );
+
+        if (
+          (decoded.low != images[i].low) || (decoded.high != images[i].high)
+        ) {
+          errors[t] = 1;
+        }
+      }
+    }
+  };
+
+  std::vector<std::thread> threads;
+  for (std::size_t t = 0; t < errors.size(); ++t) {
+    threads.emplace_back(worker, t);
+  }
+  for (auto &thread : threads) {
+    thread.join();
+  }
+
+  for (int e : errors) {
+    if (e) {
+      std::cerr << "[ FAIL ] Decoder over a shared rom" << std::endl;
+      return 1;
+    }
+  }
+
+  std::cout << "[ PASS ] Decoder over a shared rom" << std::endl;
+  return 0;
+}
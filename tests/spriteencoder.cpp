@@ -0,0 +1,204 @@
+#include <iostream>
+#include <stdexcept>
+#include <utility>
+#include <vector>
+
+#include <cstdint> // std::uint8_t
+
+#include "gbemu/spritedecoder.hpp"
+#include "gbemu/spriteencoder.hpp"
+
+gbemu::SpriteImage make_image(
+  std::uint8_t width, std::uint8_t height, std::uint32_t seed
+);
+gbemu::SpriteImage decode_image(
+  gbemu::Decoder &decoder, std::uint8_t bank, std::uint16_t offset
+);
+int round_trip_test(
+  const gbemu::SpriteImage &image, std::uint8_t mode, bool swap
+);
+int best_candidate_test(const gbemu::SpriteImage &image);
+int size_test();
+
+int main() {
+  int err = 0;
+
+  std::uint32_t seed = 1;
+  for (std::uint8_t width = 1; width <= 7; ++width) {
+    for (std::uint8_t height = 1; height <= 7; ++height) {
+      gbemu::SpriteImage image = make_image(width, height, seed++);
+
+      for (std::uint8_t mode = 1; mode <= 3; ++mode) {
+        err |= round_trip_test(image, mode, false);
+        err |= round_trip_test(image, mode, true);
+      }
+      err |= best_candidate_test(image);
+    }
+  }
+
+  // blank and solid sprites, a single run per plane
+  gbemu::SpriteImage blank = make_image(7, 7, 0);
+  err |= round_trip_test(blank, 1, false);
+  err |= best_candidate_test(blank);
+
+  gbemu::SpriteImage solid = blank;
+  solid.low.fill(0xff);
+  solid.high.fill(0xff);
+  err |= round_trip_test(solid, 3, true);
+  err |= best_candidate_test(solid);
+  err |= size_test();
+
+  if (!err) {
+    std::cout << "[ PASS ] Encoder round trips" << std::endl;
+  }
+
+  return err;
+}
+
+gbemu::SpriteImage make_image(
+  std::uint8_t width, std::uint8_t height, std::uint32_t seed
+) {
+  gbemu::SpriteImage image;
+  image.width = width;
+  image.height = height;
+
+  if (seed == 0) {
+    return image;
+  }
+
+  // runs of one colour, so both packet types turn up
+  std::uint32_t state = seed;
+  std::uint8_t pixel = 0;
+  std::size_t num_rows = height * 8;
+  for (std::size_t y = 0; y < num_rows; ++y) {
+    for (std::size_t x = 0; x < std::size_t(width * 8); ++x) {
+      state ^= state << 13;
+      state ^= state >> 17;
+      state ^= state << 5;
+
+      if ((state % 7) == 0) {
+        pixel = (state >> 8) & 0b11;
+      }
+
+      std::size_t index = ((x / 8) * num_rows) + y;
+      std::uint8_t mask = 0b10000000 >> (x % 8);
+      if (pixel & 0b01) {
+        image.low[index] |= mask;
+      }
+      if (pixel & 0b10) {
+        image.high[index] |= mask;
+      }
+    }
+  }
+
+  return image;
+}
+
+gbemu::SpriteImage decode_image(
+  gbemu::Decoder &decoder, std::uint8_t bank, std::uint16_t offset
+) {
+  decoder.clear(0);
+  decoder.clear(1);
+  decoder.clear(2);
+  decoder.set_bank(bank);
+  decoder.set_offset(offset);
+  decoder.read_header();
+  decoder.rle_decode(decoder.primary_buffer);
+  decoder.read_encoding_mode();
+  decoder.rle_decode(decoder.secondary_buffer);
+  decoder.delta_decode(decoder.primary_buffer);
+  if (decoder.encoding_mode != 2) {
+    decoder.delta_decode(decoder.secondary_buffer);
+  }
+
+  std::array<std::uint8_t, gbemu::SPRITE_SIZE> tiles;
+  decoder.finalise(tiles);
+
+  return gbemu::image_from_tiles(tiles, decoder.width, decoder.height);
+}
+
+int round_trip_test(
+  const gbemu::SpriteImage &image, std::uint8_t mode, bool swap
+) {
+  gbemu::Encoder encoder;
+  gbemu::EncodedSprite encoded = encoder.encode(image, mode, swap);
+
+  // the decoder reads from a rom, so put the sprite in bank 1 of a minimal
+  // rom image
+  std::vector<std::uint8_t> rom(0x8000, 0x00);
+  std::copy(encoded.data.begin(), encoded.data.end(), rom.begin() + 0x4000);
+
+  gbemu::Decoder decoder(rom);
+  gbemu::SpriteImage decoded = decode_image(decoder, 1, 0x4000);
+
+  // tell() counts from the start of bank 1, where the sprite was put
+  std::size_t bits = decoder.rom_interface.tell();
+
+  if (
+    (decoded.width != image.width) || (decoded.height != image.height) ||
+    (decoded.low != image.low) || (decoded.high != image.high) ||
+    (decoder.encoding_mode != mode) || (decoder.swap_buffers != swap) ||
+    (bits != encoded.bit_count)
+  ) {
+    std::cerr << "[ FAIL ] Encoder.encode() " << int(image.width) << "x";
+    std::cerr << int(image.height) << " mode " << int(mode);
+    std::cerr << " swap " << swap << ": read " << bits << " of ";
+    std::cerr << encoded.bit_count << " bits" << std::endl;
+    return 1;
+  }
+
+  return 0;
+}
+
+int best_candidate_test(const gbemu::SpriteImage &image) {
+  gbemu::Encoder serial(1);
+  gbemu::Encoder parallel(4);
+
+  gbemu::EncodedSprite best = serial.encode(image);
+  gbemu::EncodedSprite best_parallel = parallel.encode(image);
+
+  if (
+    (best.data != best_parallel.data) ||
+    (best.encoding_mode != best_parallel.encoding_mode) ||
+    (best.swap_buffers != best_parallel.swap_buffers)
+  ) {
+    std::cerr << "[ FAIL ] Encoder.encode() serial and parallel differ";
+    std::cerr << std::endl;
+    return 1;
+  }
+
+  for (std::uint8_t mode = 1; mode <= 3; ++mode) {
+    for (bool swap : {false, true}) {
+      if (serial.encode(image, mode, swap).bit_count < best.bit_count) {
+        std::cerr << "[ FAIL ] Encoder.encode() missed a shorter candidate";
+        std::cerr << std::endl;
+        return 1;
+      }
+    }
+  }
+
+  return round_trip_test(image, best.encoding_mode, best.swap_buffers);
+}
+
+int size_test() {
+  // 8x6 and 6x8 fit in a plane's bytes but not in its 7x7 tiles
+  std::vector<std::pair<std::uint8_t, std::uint8_t>> sizes = {
+    {0, 1}, {1, 0}, {8, 6}, {6, 8}, {8, 1}, {1, 8}, {15, 1}
+  };
+
+  gbemu::Encoder encoder;
+  for (auto [width, height] : sizes) {
+    gbemu::SpriteImage image;
+    image.width = width;
+    image.height = height;
+
+    try {
+      encoder.encode(image, 1, false);
+      std::cerr << "[ FAIL ] Encoder.encode() accepted " << int(width);
+      std::cerr << "x" << int(height) << std::endl;
+      return 1;
+    } catch (std::out_of_range &e) {}
+  }
+
+  return 0;
+}
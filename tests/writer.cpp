@@ -0,0 +1,178 @@
+#include <filesystem>
+#include <iostream>
+#include <span>
+#include <string>
+#include <vector>
+
+#include <cstdint> // std::uint8_t
+
+#include "util/io.hpp"
+#include "util/writer.hpp"
+
+std::vector<std::uint8_t> make_data(std::size_t n);
+int write_test(bool try_io_uring);
+int failure_test(bool try_io_uring);
+int gathered_write_test();
+
+int main() {
+  int err = 0;
+
+  err |= write_test(true);
+  err |= write_test(false);
+  err |= failure_test(true);
+  err |= failure_test(false);
+  err |= gathered_write_test();
+
+  return err;
+}
+
+std::vector<std::uint8_t> make_data(std::size_t n) {
+  // different sizes, including empty files and more than one page
+  std::vector<std::uint8_t> data((n * 977) % 9000);
+  for (std::size_t i = 0; i < data.size(); ++i) {
+    data[i] = (i * 31) + n;
+  }
+
+  return data;
+}
+
+int write_test(bool try_io_uring) {
+  std::string name = "OutputWriter";
+  name += try_io_uring ? " (io_uring)" : " (pool)";
+
+  std::filesystem::path root = std::filesystem::temp_directory_path();
+  root /= "pkmn_sprite_writer_test";
+  std::filesystem::remove_all(root);
+
+  // more files than fit in one batch, spread over a few directories
+  constexpr std::size_t file_count = 200;
+  {
+    OutputWriter writer(3, try_io_uring);
+
+    for (std::size_t n = 0; n < file_count; ++n) {
+      std::filesystem::path path = root / std::to_string(n % 3) / "a";
+      path /= std::to_string(n) + ".bin";
+      writer.write(path, make_data(n));
+    }
+
+    if (writer.flush() != 0) {
+      std::cerr << "[ FAIL ] " << name << ".flush() reported errors";
+      std::cerr << std::endl;
+      std::filesystem::remove_all(root);
+      return 1;
+    }
+
+    // the destructor writes anything queued after the last flush
+    std::filesystem::path path = root / "late.bin";
+    writer.write(path, make_data(1));
+  }
+
+  int err = 0;
+  for (std::size_t n = 0; n < file_count; ++n) {
+    std::filesystem::path path = root / std::to_string(n % 3) / "a";
+    path /= std::to_string(n) + ".bin";
+
+    if (
+      !std::filesystem::exists(path) || (loadFromFile(path) != make_data(n))
+    ) {
+      std::cerr << "[ FAIL ] " << name << ".write(): " << path << std::endl;
+      err = 1;
+      break;
+    }
+  }
+
+  if (!err && (loadFromFile(root / "late.bin") != make_data(1))) {
+    std::cerr << "[ FAIL ] " << name << " destructor did not flush";
+    std::cerr << std::endl;
+    err = 1;
+  }
+
+  std::filesystem::remove_all(root);
+
+  if (!err) {
+    std::cout << "[ PASS ] " << name << ".write()" << std::endl;
+  }
+
+  return err;
+}
+
+int failure_test(bool try_io_uring) {
+  std::string name = "OutputWriter";
+  name += try_io_uring ? " (io_uring)" : " (pool)";
+
+  std::filesystem::path root = std::filesystem::temp_directory_path();
+  root /= "pkmn_sprite_writer_failure_test";
+  std::filesystem::remove_all(root);
+
+  // a regular file where a directory needs to be
+  std::filesystem::path blocker = root / "blocker";
+  writeToFile(blocker, std::vector<std::uint8_t>(1, 0x00), true);
+
+  // one file that cannot get its directory, one that cannot be opened
+  OutputWriter writer(2, try_io_uring);
+  writer.write(blocker / "a.bin", make_data(1));
+  writer.write(root, make_data(1));
+  writer.write(root / "b.bin", make_data(2));
+
+  // errors are only counted once
+  std::size_t failed = writer.flush();
+  std::size_t failed_again = writer.flush();
+
+  bool written = (loadFromFile(root / "b.bin") == make_data(2));
+  std::filesystem::remove_all(root);
+
+  if ((failed != 2) || (failed_again != 0) || !written) {
+    std::cerr << "[ FAIL ] " << name << ".flush(): got " << failed;
+    std::cerr << " and " << failed_again << " failures, expected 2 and 0";
+    std::cerr << std::endl;
+    return 1;
+  }
+
+  std::cout << "[ PASS ] " << name << ".flush()" << std::endl;
+  return 0;
+}
+
+int gathered_write_test() {
+  std::filesystem::path path = std::filesystem::temp_directory_path();
+  path /= "pkmn_sprite_gathered_write_test.bin";
+
+  std::vector<std::uint8_t> header = {'P', '5', '\n'};
+  std::vector<std::uint8_t> payload = make_data(7);
+  std::span<const std::uint8_t> parts[] = {header, {}, payload};
+
+  int err = writeToFile(path, parts);
+  std::vector<std::uint8_t> written = loadFromFile(path);
+  std::filesystem::remove(path);
+
+  std::vector<std::uint8_t> expected = header;
+  expected.insert(expected.end(), payload.begin(), payload.end());
+
+  if (err || (written != expected)) {
+    std::cerr << "[ FAIL ] writeToFile() with parts" << std::endl;
+    return 1;
+  }
+
+  // more parts than are gathered into one writev, some of them empty
+  std::vector<std::vector<std::uint8_t>> chunks;
+  std::vector<std::span<const std::uint8_t>> many;
+  expected.clear();
+  for (std::size_t i = 0; i < 50; ++i) {
+    chunks.push_back(std::vector<std::uint8_t>(i % 3, std::uint8_t(i)));
+  }
+  for (const std::vector<std::uint8_t> &chunk : chunks) {
+    many.push_back(chunk);
+    expected.insert(expected.end(), chunk.begin(), chunk.end());
+  }
+
+  err = writeToFile(path, many);
+  written = loadFromFile(path);
+  std::filesystem::remove(path);
+
+  if (err || (written != expected)) {
+    std::cerr << "[ FAIL ] writeToFile() with many parts" << std::endl;
+    return 1;
+  }
+
+  std::cout << "[ PASS ] writeToFile() with parts" << std::endl;
+  return 0;
+}